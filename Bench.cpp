@@ -0,0 +1,1359 @@
+// Bench.cpp
+// Headless benchmarks for the server's hot paths. Each suite times a piece of
+// the tick in isolation and prints one row per configuration; --json also
+// writes every row to a file for tracking regressions across commits.
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+#include "ServerLogger.h"
+#include "ServerConfig.h"
+#include "GameServer.h"
+#include "RollbackStore.h"
+#include "PlanetIndex.h"
+#include "GravitySimulator.h"
+#include "VehicleManager.h"
+#include "Planet.h"
+#include "Rocket.h"
+#include "VectorHelper.h"
+#include "GameConstants.h"
+#include "JobSystem.h"
+#include "NetworkManager.h"
+#include "ClientManager.h"
+#include "GameState.h"
+#include "GameClient.h"
+#include "PlayerInput.h"
+#include "Log.h"
+
+#ifdef _DEBUG
+#pragma comment(lib, "sfml-system-d.lib")
+#pragma comment(lib, "sfml-network-d.lib")
+#pragma comment(lib, "sfml-window-d.lib")
+#pragma comment(lib, "sfml-graphics-d.lib")
+#else
+#pragma comment(lib, "sfml-system.lib")
+#pragma comment(lib, "sfml-network.lib")
+#pragma comment(lib, "sfml-window.lib")
+#pragma comment(lib, "sfml-graphics.lib")
+#endif
+
+struct BenchOptions {
+    std::string suite = "all";
+    int maxThreads = 0;          // 0 goes up to one thread per core
+    float minSeconds = 0.5f;     // Keep repeating a case at least this long
+    int players = 256;
+    std::string jsonFile;        // Empty prints the table only
+    unsigned short port = 5099;  // Loopback port for the network suite
+};
+
+// One measured case, kept for the JSON report
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    std::vector<std::pair<std::string, double>> params;
+    double secondsPerCall;
+    double itemsPerCall;         // bodies, vectors... handled per call; 0 if not meaningful
+};
+
+std::vector<BenchResult> benchResults;
+
+// A property a suite verifies on the side; any failure fails the run
+struct BenchCheck {
+    std::string suite;
+    std::string name;
+    bool passed;
+    std::string detail;
+};
+
+std::vector<BenchCheck> benchChecks;
+
+// Stops the optimizer from dropping results nobody reads
+volatile float benchSink = 0.0f;
+
+// Every heap allocation the process makes, so a case can check that its
+// steady state allocates nothing
+std::atomic<unsigned long long> benchAllocations(0);
+
+void* operator new(size_t size) {
+    benchAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void parseCommandLine(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--suite" && i + 1 < argc) {
+            options.suite = argv[++i];
+        }
+        else if (arg == "--max-threads" && i + 1 < argc) {
+            options.maxThreads = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--min-time" && i + 1 < argc) {
+            options.minSeconds = std::stof(argv[++i]);
+        }
+        else if (arg == "--players" && i + 1 < argc) {
+            options.players = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<unsigned short>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--json" && i + 1 < argc) {
+            options.jsonFile = argv[++i];
+        }
+        else if (arg == "--help") {
+            std::cout << "KatieBench - Server benchmarks" << std::endl;
+            std::cout << "Usage: KatieBench [options]" << std::endl;
+            std::cout << "Options:" << std::endl;
+            std::cout << "  --suite NAME         jobs, physics, prediction, serialization, network or all (default: all)" << std::endl;
+            std::cout << "  --max-threads NUM    Largest thread count to scale to (default: one per core)" << std::endl;
+            std::cout << "  --min-time SECONDS   Minimum time spent on each case (default: 0.5)" << std::endl;
+            std::cout << "  --players NUM        Players on the benchmark server (default: 256)" << std::endl;
+            std::cout << "  --port PORT          Loopback port for the network suite (default: 5099)" << std::endl;
+            std::cout << "  --json FILE          Also write every result to FILE as JSON" << std::endl;
+            std::cout << "  --help               Display this help message" << std::endl;
+            exit(0);
+        }
+    }
+}
+
+// Run body until minSeconds have passed (after one warm-up call) and return seconds per call
+double timePerCall(const std::function<void()>& body, float minSeconds) {
+    body();
+
+    auto start = std::chrono::steady_clock::now();
+    long calls = 0;
+    double elapsed = 0.0;
+    do {
+        body();
+        calls++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed / calls;
+}
+
+// Like timePerCall, but setup runs before every call and is left out of the time
+double timePerCallWithSetup(const std::function<void()>& setup, const std::function<void()>& body, float minSeconds) {
+    setup();
+    body();
+
+    long calls = 0;
+    double measured = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    do {
+        setup();
+        auto callStart = std::chrono::steady_clock::now();
+        body();
+        measured += std::chrono::duration<double>(std::chrono::steady_clock::now() - callStart).count();
+        calls++;
+    } while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < minSeconds);
+
+    return measured / calls;
+}
+
+void printScalingRow(const std::string& name, unsigned int threads, double seconds, double serialSeconds) {
+    std::cout << std::left << std::setw(28) << name << std::right
+        << std::setw(8) << threads
+        << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1000.0
+        << std::setw(10) << std::setprecision(2) << serialSeconds / seconds << "x" << std::endl;
+
+    benchResults.push_back({ "jobs", name, { { "threads", threads }, { "speedup", serialSeconds / seconds } }, seconds, 0.0 });
+}
+
+// Print a row of a per-case suite and keep it for the JSON report
+void reportCase(const std::string& suite, const std::string& name,
+    const std::vector<std::pair<std::string, double>>& params, double seconds, double items) {
+    std::string label = name;
+    for (size_t i = 0; i < params.size(); i++) {
+        std::ostringstream value;
+        value << params[i].second;
+        label += (i == 0 ? " " : ", ") + params[i].first + "=" + value.str();
+    }
+
+    std::cout << std::left << std::setw(66) << label << std::right
+        << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1e6;
+    if (items > 0) {
+        std::cout << std::setw(12) << std::setprecision(2) << seconds * 1e9 / items;
+    }
+    std::cout << std::endl;
+
+    benchResults.push_back({ suite, name, params, seconds, items });
+}
+
+// Print a pass/fail line and keep it for the JSON report and the exit code
+bool checkCase(const std::string& suite, const std::string& name, bool passed, const std::string& detail) {
+    std::cout << (passed ? "  ok    " : "  FAIL  ") << name << " - " << detail << std::endl;
+    benchChecks.push_back({ suite, name, passed, detail });
+    return passed;
+}
+
+void writeJson(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Could not write " << path << std::endl;
+        return;
+    }
+
+    file << std::setprecision(9);
+    file << "{\n  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n  \"results\": [";
+    for (size_t i = 0; i < benchResults.size(); i++) {
+        const BenchResult& result = benchResults[i];
+        file << (i == 0 ? "\n" : ",\n")
+            << "    {\"suite\": \"" << result.suite << "\", \"name\": \"" << result.name << "\", \"params\": {";
+        for (size_t p = 0; p < result.params.size(); p++) {
+            file << (p == 0 ? "" : ", ") << "\"" << result.params[p].first << "\": " << result.params[p].second;
+        }
+        file << "}, \"nsPerCall\": " << result.secondsPerCall * 1e9
+            << ", \"callsPerSecond\": " << 1.0 / result.secondsPerCall;
+        if (result.itemsPerCall > 0) {
+            file << ", \"nsPerItem\": " << result.secondsPerCall * 1e9 / result.itemsPerCall;
+        }
+        file << "}";
+    }
+    file << "\n  ],\n  \"checks\": [";
+    for (size_t i = 0; i < benchChecks.size(); i++) {
+        const BenchCheck& check = benchChecks[i];
+        file << (i == 0 ? "\n" : ",\n")
+            << "    {\"suite\": \"" << check.suite << "\", \"name\": \"" << check.name
+            << "\", \"passed\": " << (check.passed ? "true" : "false")
+            << ", \"detail\": \"" << check.detail << "\"}";
+    }
+    file << "\n  ]\n}\n";
+
+    std::cout << "Wrote " << benchResults.size() << " results and " << benchChecks.size()
+        << " checks to " << path << std::endl;
+}
+
+// A server with players spread on a ring around the sun, like a busy room
+void populateServer(GameServer& server, int players) {
+    server.initialize();
+
+    const Planet* sun = server.getPlanets()[0];
+    float ring = sun->getRadius() * 3.0f;
+    for (int id = 1; id <= players; id++) {
+        float angle = 2.0f * GameConstants::PI * id / players;
+        sf::Vector2f position = sun->getPosition() + sf::Vector2f(std::cos(angle), std::sin(angle)) * ring;
+        server.addPlayer(id, position);
+    }
+}
+
+// Thrust, turn and coast in a fixed pattern so every run sends the same inputs
+void scriptControls(int tick, PlayerInput& input) {
+    int phase = tick % 80;
+    input.b = phase < 30;                   // thrustForward
+    input.d = phase >= 20 && phase < 35;    // rotateLeft
+    input.e = phase >= 50 && phase < 60;    // rotateRight
+}
+
+// Fork/join, nested waits and parallelFor coverage on a job system with the
+// given number of workers. More workers than cores still has to be correct
+void checkJobSystem(unsigned int workerCount) {
+    JobSystem jobs(workerCount);
+    std::string workers = std::to_string(workerCount) + " workers";
+
+    // Every forked job has run once wait returns
+    {
+        const int jobCount = 1000;
+        std::atomic<int> ran(0);
+        TaskGroup group(jobs);
+        for (int i = 0; i < jobCount; i++) {
+            group.run([&ran]() { ran.fetch_add(1); });
+        }
+        group.wait();
+
+        int count = ran.load();
+        checkCase("jobs", "TaskGroup fork/join", count == jobCount,
+            workers + ": " + std::to_string(count) + " of " + std::to_string(jobCount) + " jobs ran");
+    }
+
+    // Jobs that fork and wait on their own groups, with workers helping out
+    // instead of blocking; each inner wait has to see all of its own jobs done
+    {
+        const int outerCount = 16;
+        const int innerCount = 16;
+        std::atomic<int> ran(0);
+        std::atomic<int> earlyReturns(0);
+        TaskGroup outer(jobs);
+        for (int i = 0; i < outerCount; i++) {
+            outer.run([&]() {
+                std::atomic<int> innerRan(0);
+                TaskGroup inner(jobs);
+                for (int j = 0; j < innerCount; j++) {
+                    inner.run([&]() {
+                        innerRan.fetch_add(1);
+                        ran.fetch_add(1);
+                        });
+                }
+                inner.wait();
+                if (innerRan.load() != innerCount) {
+                    earlyReturns.fetch_add(1);
+                }
+                });
+        }
+        outer.wait();
+
+        int count = ran.load();
+        checkCase("jobs", "nested TaskGroup waits", count == outerCount * innerCount && earlyReturns.load() == 0,
+            workers + ": " + std::to_string(count) + " of " + std::to_string(outerCount * innerCount) +
+            " inner jobs ran, " + std::to_string(earlyReturns.load()) + " waits returned early");
+    }
+
+    // Each index of [first, last) handed out exactly once and nothing outside
+    // the range. With workers, chunks are no larger than the grain; without,
+    // the whole range is one call
+    {
+        const size_t first = 5;
+        const size_t last = 100003;
+        const size_t grain = 37;
+        std::vector<std::atomic<int>> hits(last + 8);
+        for (std::atomic<int>& hit : hits) {
+            hit.store(0);
+        }
+        std::atomic<int> badChunks(0);
+
+        jobs.parallelFor(first, last, grain, [&](size_t begin, size_t end) {
+            if (end <= begin || (workerCount > 0 && end - begin > grain)) {
+                badChunks.fetch_add(1);
+            }
+            for (size_t i = begin; i < end && i < hits.size(); i++) {
+                hits[i].fetch_add(1);
+            }
+            });
+
+        size_t wrong = 0;
+        for (size_t i = 0; i < hits.size(); i++) {
+            int expected = (i >= first && i < last) ? 1 : 0;
+            if (hits[i].load() != expected) wrong++;
+        }
+        checkCase("jobs", "parallelFor covers every index once", wrong == 0 && badChunks.load() == 0,
+            workers + ": " + std::to_string(wrong) + " indices wrong, " +
+            std::to_string(badChunks.load()) + " chunks empty or over the grain");
+    }
+}
+
+// How the job system scales from 1 to N threads on a synthetic loop and on the real tick
+void runJobScaling(const BenchOptions& options) {
+    unsigned int maxThreads = options.maxThreads > 0 ?
+        static_cast<unsigned int>(options.maxThreads) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== Job system scaling (" << std::thread::hardware_concurrency() << " cores) ===" << std::endl;
+    for (unsigned int workerCount : { 0u, 1u, 3u }) {
+        checkJobSystem(workerCount);
+    }
+    std::cout << std::left << std::setw(28) << "case" << std::right << std::setw(8) << "threads"
+        << std::setw(12) << "ms/iter" << std::setw(11) << "speedup" << std::endl;
+
+    // Pure arithmetic with no shared writes: the upper bound on speedup
+    const size_t pointCount = 65536;
+    std::vector<sf::Vector2f> points(pointCount);
+    std::vector<sf::Vector2f> accelerations(pointCount);
+    for (size_t i = 0; i < pointCount; i++) {
+        points[i] = sf::Vector2f(static_cast<float>(i % 256) * 10.0f, static_cast<float>(i / 256) * 10.0f);
+    }
+    const sf::Vector2f sources[] = {
+        sf::Vector2f(400.f, 300.f), sf::Vector2f(900.f, 200.f), sf::Vector2f(1500.f, 1800.f), sf::Vector2f(-300.f, 700.f)
+    };
+
+    auto gravityBody = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            sf::Vector2f total(0.f, 0.f);
+            for (const sf::Vector2f& source : sources) {
+                sf::Vector2f dir = source - points[i];
+                float distSq = dir.x * dir.x + dir.y * dir.y + 1.0f;
+                total += dir * (GameConstants::G / (distSq * std::sqrt(distSq)));
+            }
+            accelerations[i] = total;
+        }
+        };
+
+    double serialSynthetic = 0.0;
+    double serialUpdate = 0.0;
+    double serialSnapshot = 0.0;
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads++) {
+        JobSystem jobs(threads - 1);
+
+        double synthetic = timePerCall([&]() {
+            jobs.parallelFor(0, pointCount, 1024, gravityBody);
+            }, options.minSeconds);
+
+        ServerConfig config;
+        config.setMaxClients(options.players + 1);
+        config.setVerbose(false);
+        ServerLogger logger("bench_log.txt", false);
+        Log::ScopedSink logSink(logger);
+        GameServer server(logger, config);
+        populateServer(server, options.players);
+        server.setJobSystem(&jobs);
+
+        double update = timePerCall([&]() {
+            server.update(config.getUpdateRate());
+            }, options.minSeconds);
+
+        double snapshot = timePerCall([&]() {
+            GameState state = server.getGameState();
+            }, options.minSeconds);
+
+        if (threads == 1) {
+            serialSynthetic = synthetic;
+            serialUpdate = update;
+            serialSnapshot = snapshot;
+        }
+
+        printScalingRow("parallelFor 64k gravity", threads, synthetic, serialSynthetic);
+        printScalingRow("GameServer::update " + std::to_string(options.players) + "p", threads, update, serialUpdate);
+        printScalingRow("getGameState " + std::to_string(options.players) + "p", threads, snapshot, serialSnapshot);
+    }
+    std::cout << std::endl;
+}
+
+// Planets spread on a spiral far enough apart that none touch. The simulator
+// only changes velocities, so repeated updates keep the same layout
+std::vector<Planet*> makeSpacedPlanets(int count) {
+    std::vector<Planet*> planets;
+    planets.push_back(new Planet(sf::Vector2f(0.f, 0.f), 0.0f, GameConstants::MAIN_PLANET_MASS, sf::Color::Yellow));
+    for (int i = 1; i < count; i++) {
+        float angle = 2.39996f * i;   // golden angle
+        float ring = 600.0f + 400.0f * std::sqrt(static_cast<float>(i));
+        planets.push_back(new Planet(sf::Vector2f(std::cos(angle), std::sin(angle)) * ring, 0.0f, 1000.0f, sf::Color::Blue));
+    }
+    return planets;
+}
+
+void deletePlanets(std::vector<Planet*>& planets) {
+    for (Planet* planet : planets) {
+        delete planet;
+    }
+    planets.clear();
+}
+
+// The simulation building blocks one at a time, at several sizes
+void runPhysics(const BenchOptions& options) {
+    std::cout << "=== Physics ===" << std::endl;
+    std::cout << std::left << std::setw(66) << "case" << std::right
+        << std::setw(12) << "us/call" << std::setw(12) << "ns/item" << std::endl;
+
+    const float dt = GameConstants::SERVER_UPDATE_RATE;
+
+    // Planet-planet gravity is O(planets^2), rocket-rocket O(rockets^2)
+    for (int planetCount : { 10, 50, 200 }) {
+        for (int rocketCount : { 0, 16, 64 }) {
+            std::vector<Planet*> planets = makeSpacedPlanets(planetCount);
+            std::vector<Rocket*> rockets;
+            GravitySimulator simulator;
+            for (Planet* planet : planets) {
+                simulator.addPlanet(planet);
+            }
+            for (int i = 0; i < rocketCount; i++) {
+                float angle = 2.0f * GameConstants::PI * i / std::max(1, rocketCount);
+                rockets.push_back(new Rocket(sf::Vector2f(std::cos(angle), std::sin(angle)) * 350.0f, sf::Vector2f(0.f, 0.f), i + 1));
+                simulator.addRocket(rockets.back());
+            }
+
+            double seconds = timePerCall([&]() {
+                simulator.update(dt);
+                }, options.minSeconds);
+            reportCase("physics", "GravitySimulator::update",
+                { { "planets", planetCount }, { "rockets", rocketCount } }, seconds, planetCount + rocketCount);
+
+            for (Rocket* rocket : rockets) {
+                delete rocket;
+            }
+            deletePlanets(planets);
+        }
+    }
+
+    // Planets moved by fixed ticks, against block timesteps as the server and
+    // client do, from a fresh layout stepped once so the block steps hold
+    // their accelerations as they do from tick to tick. Block steps pay one
+    // pull pass per update like fixed ticks, plus one per extra substep while
+    // a planet skims past the sun
+    for (int planetCount : { 10, 50, 200 }) {
+        for (bool closePass : { false, true }) {
+            for (bool blockTimesteps : { false, true }) {
+                std::unique_ptr<GravitySimulator> simulator;
+                unsigned int substeps = 1;
+
+                auto step = [&]() {
+                    simulator->update(dt);
+                    if (!blockTimesteps) {
+                        for (Planet* planet : simulator->getPlanets()) {
+                            planet->update(dt);
+                        }
+                    }
+                    substeps = simulator->getSubstepCount();
+                };
+
+                auto setup = [&]() {
+                    if (simulator) {
+                        std::vector<Planet*> left = simulator->getPlanets();
+                        deletePlanets(left);
+                    }
+                    simulator.reset(new GravitySimulator());
+                    simulator->setBlockTimesteps(blockTimesteps);
+
+                    std::vector<Planet*> planets = makeSpacedPlanets(planetCount);
+                    if (closePass) {
+                        float reach = planets[0]->getRadius() + planets[1]->getRadius() + 10.0f;
+                        float speed = std::sqrt(GameConstants::G * planets[0]->getMass() / reach);
+                        planets[1]->setPosition(sf::Vector2f(reach, 0.f));
+                        planets[1]->setVelocity(sf::Vector2f(0.f, speed));
+                    }
+                    for (Planet* planet : planets) {
+                        simulator->addPlanet(planet);
+                    }
+                    step();
+                };
+
+                double seconds = timePerCallWithSetup(setup, step, options.minSeconds);
+                reportCase("physics", blockTimesteps ? "GravitySimulator::update blockTimesteps" : "GravitySimulator::update fixedStep",
+                    { { "planets", planetCount }, { "closePass", closePass ? 1.0 : 0.0 }, { "substeps", static_cast<double>(substeps) } },
+                    seconds, planetCount);
+
+                std::vector<Planet*> left = simulator->getPlanets();
+                deletePlanets(left);
+            }
+        }
+    }
+
+    // Accuracy of both steppers on a planet whose eccentric orbit skims the
+    // sun, against fixed steps 256 times finer. The sun is pinned, so the
+    // planet's orbital energy should stay put; how far it wanders is the
+    // other measure. Block steps have to beat fixed ticks on both
+    {
+        const int ticks = 2000;
+        const int referenceSubsteps = 256;
+        const float sunMass = GameConstants::MAIN_PLANET_MASS;
+        const float orbit = GameConstants::PLANET_ORBIT_DISTANCE;
+        const float circularSpeed = std::sqrt(GameConstants::G * sunMass / orbit);
+
+        struct OrbitRun {
+            bool intact;            // no merge along the way
+            sf::Vector2f position;
+            double energyDrift;     // largest relative change of orbital energy
+            double averageSubsteps;
+        };
+
+        auto runOrbit = [&](bool blockTimesteps, int subdivide) {
+            GravitySimulator simulator;
+            simulator.setBlockTimesteps(blockTimesteps);
+            Planet* sun = new Planet(sf::Vector2f(0.f, 0.f), 0.0f, sunMass, sf::Color::Yellow);
+            Planet* planet = new Planet(sf::Vector2f(orbit, 0.f), 0.0f, sunMass * 0.01f, sf::Color::Blue);
+            planet->setVelocity(sf::Vector2f(0.f, circularSpeed * 0.32f));
+            simulator.addPlanet(sun);
+            simulator.addPlanet(planet);
+
+            auto energy = [&]() {
+                sf::Vector2f velocity = planet->getVelocity();
+                return 0.5 * (velocity.x * velocity.x + velocity.y * velocity.y) -
+                    GameConstants::G * sunMass / distance(planet->getPosition(), sun->getPosition());
+            };
+
+            OrbitRun run = { true, sf::Vector2f(0.f, 0.f), 0.0, 0.0 };
+            const double initialEnergy = energy();
+            const float step = dt / subdivide;
+            for (int i = 0; i < ticks * subdivide; i++) {
+                simulator.update(step);
+                if (simulator.getPlanets().size() < 2) {
+                    run.intact = false;
+                    break;
+                }
+                if (!blockTimesteps) {
+                    for (Planet* body : simulator.getPlanets()) {
+                        body->update(step);
+                    }
+                }
+                run.averageSubsteps += simulator.getSubstepCount();
+                run.energyDrift = std::max(run.energyDrift, std::abs((energy() - initialEnergy) / initialEnergy));
+            }
+
+            if (run.intact) {
+                run.position = planet->getPosition();
+                run.averageSubsteps /= ticks * subdivide;
+            }
+            std::vector<Planet*> left = simulator.getPlanets();
+            deletePlanets(left);
+            return run;
+        };
+
+        OrbitRun reference = runOrbit(false, referenceSubsteps);
+        OrbitRun fixedStep = runOrbit(false, 1);
+        OrbitRun blockSteps = runOrbit(true, 1);
+
+        bool intact = reference.intact && fixedStep.intact && blockSteps.intact;
+        float fixedError = distance(fixedStep.position, reference.position);
+        float blockError = distance(blockSteps.position, reference.position);
+
+        std::ostringstream positionDetail;
+        positionDetail << ticks << " ticks: " << blockError << " from the reference with block steps ("
+            << blockSteps.averageSubsteps << " substeps per tick), " << fixedError << " with fixed ticks";
+        checkCase("physics", "block timesteps track a close orbit", intact && blockError < fixedError, positionDetail.str());
+
+        std::ostringstream energyDetail;
+        energyDetail << "largest energy change " << blockSteps.energyDrift * 100.0 << "% with block steps, "
+            << fixedStep.energyDrift * 100.0 << "% with fixed ticks";
+        checkCase("physics", "block timesteps hold orbital energy", intact && blockSteps.energyDrift < fixedStep.energyDrift,
+            energyDetail.str());
+    }
+
+    // Collision pass with a share of the planets overlapping a neighbour. A
+    // fresh set is built before each call since merges delete planets
+    for (int mergePercent : { 0, 10, 50 }) {
+        const int planetCount = 100;
+        std::unique_ptr<GravitySimulator> simulator;
+        size_t merges = 0;
+
+        auto setup = [&]() {
+            if (simulator) {
+                std::vector<Planet*> left = simulator->getPlanets();
+                deletePlanets(left);
+            }
+            simulator.reset(new GravitySimulator());
+            simulator->setSimulatePlanetGravity(false);
+
+            std::vector<Planet*> planets = makeSpacedPlanets(planetCount);
+            int overlapping = planetCount * mergePercent / 100;
+            for (int i = 0; i < overlapping / 2; i++) {
+                // Pairs from the outer end of the spiral; move one onto its partner
+                Planet* target = planets[planetCount - 1 - 2 * i];
+                planets[planetCount - 2 - 2 * i]->setPosition(target->getPosition() + sf::Vector2f(5.f, 0.f));
+            }
+            for (Planet* planet : planets) {
+                simulator->addPlanet(planet);
+            }
+        };
+
+        double seconds = timePerCallWithSetup(setup, [&]() {
+            size_t before = simulator->getPlanets().size();
+            simulator->update(0.0f);
+            merges = before - simulator->getPlanets().size();
+            }, options.minSeconds);
+        reportCase("physics", "GravitySimulator::checkPlanetCollisions",
+            { { "planets", planetCount }, { "mergePercent", mergePercent }, { "merges", static_cast<double>(merges) } },
+            seconds, planetCount);
+
+        std::vector<Planet*> left = simulator->getPlanets();
+        deletePlanets(left);
+    }
+
+    // Every player's vehicle update against the default ten-planet system,
+    // finding planets through a shared index as the server does
+    for (int playerCount : { 16, 64, 256 }) {
+        std::vector<Planet*> planets = makeSpacedPlanets(10);
+        PlanetIndex index;
+        index.rebuild(planets);
+        std::vector<VehicleManager*> players;
+        for (int i = 0; i < playerCount; i++) {
+            float angle = 2.0f * GameConstants::PI * i / playerCount;
+            players.push_back(new VehicleManager(sf::Vector2f(std::cos(angle), std::sin(angle)) * 350.0f, std::vector<Planet*>(), i + 1));
+            players.back()->setPlanetIndex(&index);
+        }
+
+        double seconds = timePerCall([&]() {
+            for (VehicleManager* player : players) {
+                player->update(dt);
+            }
+            }, options.minSeconds);
+        reportCase("physics", "VehicleManager::update", { { "players", playerCount }, { "planets", 10 } }, seconds, playerCount);
+
+        for (VehicleManager* player : players) {
+            delete player;
+        }
+        deletePlanets(planets);
+    }
+
+    // Rocket gravity for every player: one call per rocket, as the server used
+    // to do, against the batched pass over rockets x planets
+    for (int rocketCount : { 16, 64, 256 }) {
+        std::vector<Planet*> planets = makeSpacedPlanets(10);
+        GravitySimulator simulator;
+        for (Planet* planet : planets) {
+            simulator.addPlanet(planet);
+        }
+        std::vector<VehicleManager*> players;
+        for (int i = 0; i < rocketCount; i++) {
+            float angle = 2.0f * GameConstants::PI * i / rocketCount;
+            players.push_back(new VehicleManager(sf::Vector2f(std::cos(angle), std::sin(angle)) * 350.0f, std::vector<Planet*>(), i + 1));
+            simulator.addVehicleManager(players.back());
+        }
+
+        double eachSeconds = timePerCall([&]() {
+            for (VehicleManager* player : players) {
+                simulator.applyGravityToRocket(player->getRocket(), dt);
+            }
+            }, options.minSeconds);
+        reportCase("physics", "GravitySimulator::applyGravityToRocket each",
+            { { "rockets", rocketCount }, { "planets", 10 } }, eachSeconds, rocketCount);
+
+        double batchSeconds = timePerCall([&]() {
+            simulator.applyGravityToVehicles(dt);
+            }, options.minSeconds);
+        reportCase("physics", "GravitySimulator::applyGravityToVehicles",
+            { { "rockets", rocketCount }, { "planets", 10 } }, batchSeconds, rocketCount);
+
+        for (VehicleManager* player : players) {
+            delete player;
+        }
+        deletePlanets(planets);
+    }
+
+    // The planet and vehicle part of a server tick once everything has warmed
+    // up. One player keeps a planet list synced from the simulator as clients
+    // do; the rest query the index. Nothing here should allocate per tick
+    for (int playerCount : { 16, 256 }) {
+        std::vector<Planet*> planets = makeSpacedPlanets(10);
+        GravitySimulator simulator;
+        for (Planet* planet : planets) {
+            simulator.addPlanet(planet);
+        }
+        PlanetIndex index;
+        std::vector<VehicleManager*> players;
+        for (int i = 0; i < playerCount; i++) {
+            float angle = 2.0f * GameConstants::PI * i / playerCount;
+            players.push_back(new VehicleManager(sf::Vector2f(std::cos(angle), std::sin(angle)) * 350.0f, std::vector<Planet*>(), i + 1));
+            if (i > 0) players.back()->setPlanetIndex(&index);
+        }
+        simulator.addVehicleManager(players[0]);
+
+        auto tick = [&]() {
+            simulator.update(dt);
+            for (Planet* planet : simulator.getPlanets()) {
+                planet->update(dt);
+            }
+            index.rebuild(simulator.getPlanets());
+            for (VehicleManager* player : players) {
+                player->update(dt);
+            }
+        };
+
+        double seconds = timePerCall(tick, options.minSeconds);
+
+        const int ticks = 100;
+        unsigned long long allocationsBefore = benchAllocations.load();
+        for (int i = 0; i < ticks; i++) {
+            tick();
+        }
+        double allocationsPerTick = static_cast<double>(benchAllocations.load() - allocationsBefore) / ticks;
+
+        reportCase("physics", "planet and vehicle tick",
+            { { "players", playerCount }, { "planets", 10 }, { "allocationsPerTick", allocationsPerTick } },
+            seconds, playerCount);
+
+        std::ostringstream detail;
+        detail << playerCount << " players: " << allocationsPerTick << " allocations per tick";
+        checkCase("physics", "planet and vehicle tick allocates nothing", allocationsPerTick == 0.0, detail.str());
+
+        for (VehicleManager* player : players) {
+            delete player;
+        }
+        std::vector<Planet*> left = simulator.getPlanets();
+        deletePlanets(left);
+    }
+
+    // A whole GameServer::update with players steering and sending client
+    // states, so history, validation, corrections and metrics are covered as
+    // well. Once warm, a tick should not allocate either
+    for (int playerCount : { 16, 256 }) {
+        ServerConfig config;
+        config.setMaxClients(playerCount + 1);
+        config.setVerbose(false);
+        ServerLogger logger("bench_log.txt", false);
+        Log::ScopedSink logSink(logger);
+        GameServer server(logger, config);
+        populateServer(server, playerCount);
+
+        // Client states as they were at the start, so later ones disagree with
+        // the server and earn corrections
+        std::vector<GameState> clientStates(playerCount + 1);
+        GameState start = server.getGameState();
+        for (const RocketState& rocket : start.c) {
+            if (rocket.a > 0 && rocket.a <= playerCount) {
+                clientStates[rocket.a].c.push_back(rocket);
+            }
+        }
+
+        std::vector<int> corrections;
+        int tick = 0;
+        auto serverTick = [&]() {
+            for (int id = 1; id <= playerCount; id++) {
+                PlayerInput input;
+                input.a = id;
+                input.h = config.getUpdateRate();
+                scriptControls(tick + id * 7, input);
+                server.handlePlayerInput(id, input);
+
+                // A quarter of the players report their simulation each tick
+                if ((tick + id) % 4 == 0) {
+                    clientStates[id].a = server.getSequenceNumber();
+                    clientStates[id].b = tick * config.getUpdateRate();
+                    server.processClientSimulation(id, clientStates[id]);
+                }
+            }
+            server.update(config.getUpdateRate());
+            server.takeCorrections(corrections);
+            tick++;
+        };
+
+        double seconds = timePerCall(serverTick, options.minSeconds);
+
+        const int ticks = 100;
+        unsigned long long allocationsBefore = benchAllocations.load();
+        for (int i = 0; i < ticks; i++) {
+            serverTick();
+        }
+        double allocationsPerTick = static_cast<double>(benchAllocations.load() - allocationsBefore) / ticks;
+
+        reportCase("physics", "GameServer::update with clients",
+            { { "players", playerCount }, { "allocationsPerTick", allocationsPerTick } },
+            seconds, playerCount);
+
+        std::ostringstream detail;
+        detail << playerCount << " players: " << allocationsPerTick << " allocations per tick over "
+            << server.getValidationsRun() << " validations, " << server.getCorrectionsSent() << " corrections and "
+            << server.getCorrectionsDeferred() << " deferrals";
+        checkCase("physics", "server tick allocates nothing",
+            allocationsPerTick == 0.0 && server.getCorrectionsSent() > 0, detail.str());
+    }
+
+    // Rollback round trip on a server with players steering: restoring a
+    // capture must give back the exact state it was taken from, and stepping
+    // the same inputs from there must land on the same state as the first time
+    {
+        const int players = 16;
+        const int ticksAfter = 40;
+        ServerConfig config;
+        config.setMaxClients(players + 1);
+        config.setVerbose(false);
+        config.setDeterministic(true);
+        ServerLogger logger("bench_log.txt", false);
+        Log::ScopedSink logSink(logger);
+        GameServer server(logger, config);
+        populateServer(server, players);
+
+        auto steer = [&](int tick) {
+            for (int id = 1; id <= players; id++) {
+                PlayerInput input;
+                input.a = id;
+                input.h = config.getUpdateRate();
+                scriptControls(tick + id * 7, input);
+                server.handlePlayerInput(id, input);
+            }
+        };
+
+        int tick = 0;
+        for (; tick < 20; tick++) {
+            steer(tick);
+            server.update(config.getUpdateRate());
+        }
+
+        RollbackStore store(8, GameServer::rollbackBytes(server.getPlanets().size(), server.getPlayers().size()));
+        unsigned long captured = server.getSequenceNumber();
+        server.captureRollback(store);
+        uint64_t atCapture = hashStateBodies(server.getGameState());
+
+        for (int step = 0; step < ticksAfter; step++) {
+            steer(tick + step);
+            server.update(config.getUpdateRate());
+        }
+        uint64_t firstRun = hashStateBodies(server.getGameState());
+
+        bool restored = server.restoreRollback(store, captured);
+        uint64_t atRestore = hashStateBodies(server.getGameState());
+        for (int step = 0; step < ticksAfter; step++) {
+            steer(tick + step);
+            server.update(config.getUpdateRate());
+        }
+        uint64_t secondRun = hashStateBodies(server.getGameState());
+
+        checkCase("physics", "rollback restores the captured state", restored && atRestore == atCapture,
+            "hash at capture " + std::to_string(atCapture) + ", after restore " + std::to_string(atRestore));
+        checkCase("physics", "rollback re-simulates to the same state", restored && secondRun == firstRun && firstRun != atCapture,
+            std::to_string(ticksAfter) + " ticks later: first run " + std::to_string(firstRun) +
+            ", after rollback " + std::to_string(secondRun));
+    }
+
+    // Tunneling: rockets heading straight at a planet, crossing more than its
+    // diameter per tick and lined up so every tick ends half a step either
+    // side of it. Testing where each tick ends (isColliding, the check before
+    // swept contact) misses the planet; the swept update has to stop them on
+    // its surface
+    {
+        Planet planet(sf::Vector2f(0.f, 0.f), 0.0f, 0.1f * GameConstants::MAIN_PLANET_MASS, sf::Color::Blue);
+        std::vector<Planet*> nearby{ &planet };
+        const float reach = planet.getRadius() + GameConstants::ROCKET_SIZE;
+        const int ticks = 41;
+
+        for (float speed : { 3000.0f, 10000.0f, 40000.0f }) {
+            float step = speed * dt;
+            sf::Vector2f start(-20.5f * step, 0.0f);
+            sf::Vector2f velocity(speed, 0.0f);
+
+            Rocket pointChecked(start, velocity, 1);
+            bool pointHit = false;
+            for (int i = 0; i < ticks; i++) {
+                pointChecked.update(dt);
+                pointHit = pointHit || pointChecked.isColliding(planet);
+            }
+
+            Rocket swept(start, velocity, 1);
+            swept.setNearbyPlanets(nearby);
+            float closest = distance(swept.getPosition(), planet.getPosition());
+            for (int i = 0; i < ticks; i++) {
+                swept.update(dt);
+                closest = std::min(closest, distance(swept.getPosition(), planet.getPosition()));
+            }
+            float resting = distance(swept.getPosition(), planet.getPosition());
+            bool stopped = swept.getPosition().x < planet.getPosition().x &&
+                closest >= reach - 0.01f && resting <= reach + 1.0f;
+
+            std::ostringstream detail;
+            detail << speed << " u/s (" << step / (2.0f * reach) << " diameters per tick): tick ends "
+                << (pointHit ? "touch" : "miss") << " the planet, swept rocket "
+                << (stopped ? "stopped" : "missed") << " at " << resting << " from its center, reach " << reach;
+            checkCase("physics", "fast rocket hits the planet", !pointHit && stopped, detail.str());
+        }
+    }
+
+    // The planet index: a rebuild per tick, then one reach query per vehicle
+    for (int planetCount : { 10, 200, 1000 }) {
+        std::vector<Planet*> planets = makeSpacedPlanets(planetCount);
+        PlanetIndex index;
+
+        double rebuildSeconds = timePerCall([&]() {
+            index.rebuild(planets);
+            }, options.minSeconds);
+        reportCase("physics", "PlanetIndex::rebuild", { { "planets", planetCount } }, rebuildSeconds, planetCount);
+
+        const int queryCount = 256;
+        std::vector<Planet*> found;
+        double querySeconds = timePerCall([&]() {
+            for (int i = 0; i < queryCount; i++) {
+                found.clear();
+                sf::Vector2f point = planets[i % planets.size()]->getPosition() + sf::Vector2f(60.0f, 0.0f);
+                index.queryRadius(point, GameConstants::ROCKET_SIZE + 10.0f, found);
+            }
+            benchSink = benchSink + static_cast<float>(found.size());
+            }, options.minSeconds);
+        reportCase("physics", "PlanetIndex::queryRadius", { { "planets", planetCount }, { "queries", queryCount } },
+            querySeconds, queryCount);
+
+        deletePlanets(planets);
+    }
+
+    // Called on every merge and mass change; one cube root each
+    {
+        const int planetCount = 1024;
+        std::vector<Planet> planets;
+        planets.reserve(planetCount);
+        for (int i = 0; i < planetCount; i++) {
+            planets.emplace_back(sf::Vector2f(0.f, 0.f), 0.0f, 100.0f + i, sf::Color::Blue);
+        }
+
+        double seconds = timePerCall([&]() {
+            for (Planet& planet : planets) {
+                planet.updateRadiusFromMass();
+            }
+            benchSink = benchSink + planets.back().getRadius();
+            }, options.minSeconds);
+        reportCase("physics", "Planet::updateRadiusFromMass", { { "planets", planetCount } }, seconds, planetCount);
+    }
+
+    // The vector helpers behind every gravity term
+    {
+        const int vectorCount = 65536;
+        std::vector<sf::Vector2f> vectors(vectorCount);
+        for (int i = 0; i < vectorCount; i++) {
+            vectors[i] = sf::Vector2f(static_cast<float>(i % 251) - 125.0f, static_cast<float>(i % 127) + 1.0f);
+        }
+
+        double seconds = timePerCall([&]() {
+            sf::Vector2f sum(0.f, 0.f);
+            for (const sf::Vector2f& vector : vectors) {
+                sum += normalize(vector);
+            }
+            benchSink = benchSink + sum.x;
+            }, options.minSeconds);
+        reportCase("physics", "normalize", { { "vectors", vectorCount } }, seconds, vectorCount);
+
+        seconds = timePerCall([&]() {
+            float sum = 0.0f;
+            for (int i = 1; i < vectorCount; i++) {
+                sum += distance(vectors[i - 1], vectors[i]);
+            }
+            benchSink = benchSink + sum;
+            }, options.minSeconds);
+        reportCase("physics", "distance", { { "vectors", vectorCount } }, seconds, vectorCount - 1);
+    }
+
+    std::cout << std::endl;
+}
+
+// A snapshot of a populated server, as broadcast every tick
+GameState makeSnapshot(int players) {
+    ServerConfig config;
+    config.setMaxClients(players + 1);
+    config.setVerbose(false);
+    ServerLogger logger("bench_log.txt", false);
+    Log::ScopedSink logSink(logger);
+    GameServer server(logger, config);
+    populateServer(server, players);
+    server.update(config.getUpdateRate());
+    return server.getGameState();
+}
+
+// A headless client predicting against the real server, with inputs and
+// snapshots each held in flight for a fixed number of ticks. Both sides step
+// the same scripted inputs with the same step, so how far a reconcile still
+// moves the rocket is prediction error, not timing noise
+void runPrediction(const BenchOptions&) {
+    std::cout << "=== Prediction ===" << std::endl;
+
+    const int ticks = 400;
+    const int playerId = 1;
+    for (int latencyTicks : { 0, 2, 6 }) {
+        ServerConfig config;
+        config.setMaxClients(2);
+        config.setVerbose(false);
+        ServerLogger logger("bench_log.txt", false);
+        Log::ScopedSink logSink(logger);
+        GameServer server(logger, config);
+        populateServer(server, 1);
+        const float dt = config.getUpdateRate();
+
+        GameClient client;
+        client.initialize();
+        client.setLocalPlayerId(playerId);
+
+        std::deque<std::pair<int, PlayerInput>> uplink;
+        std::deque<std::pair<int, GameState>> downlink;
+        downlink.emplace_back(latencyTicks, server.getGameState());
+
+        // The first snapshot moves the placeholder rocket to its spawn point;
+        // only the reconciles after it say anything about prediction
+        unsigned long snapshots = 0;
+        unsigned long reconciles = 0;
+        double totalCorrection = 0.0;
+        float maxCorrection = 0.0f;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; tick++) {
+            // Snapshots due by now reach the client before it predicts this tick
+            while (!downlink.empty() && downlink.front().first <= tick) {
+                unsigned long before = client.getPrediction().getReconcileCount();
+                client.processGameState(downlink.front().second);
+                downlink.pop_front();
+
+                if (snapshots++ > 0 && client.getPrediction().getReconcileCount() > before) {
+                    float correction = client.getPrediction().getLastCorrection();
+                    totalCorrection += correction;
+                    maxCorrection = std::max(maxCorrection, correction);
+                    reconciles++;
+                }
+            }
+
+            if (client.isConnected()) {
+                PlayerInput input = client.makePlayerInput(dt);
+                scriptControls(tick, input);
+                client.applyLocalInput(input);
+                uplink.emplace_back(tick + latencyTicks, input);
+            }
+            client.update(dt);
+
+            while (!uplink.empty() && uplink.front().first <= tick) {
+                server.handlePlayerInput(playerId, uplink.front().second);
+                uplink.pop_front();
+            }
+            server.update(dt);
+            downlink.emplace_back(tick + latencyTicks, server.getGameState());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / ticks;
+
+        double averageCorrection = reconciles > 0 ? totalCorrection / reconciles : 0.0;
+        reportCase("prediction", "client and server tick",
+            { { "latencyTicks", latencyTicks }, { "reconciles", static_cast<double>(reconciles) },
+            { "avgCorrection", averageCorrection }, { "maxCorrection", maxCorrection } },
+            seconds, 0);
+
+        std::ostringstream detail;
+        detail << "latency " << latencyTicks << " ticks: " << reconciles << " reconciles, average "
+            << averageCorrection << ", max " << maxCorrection;
+        checkCase("prediction", "corrections stay small", reconciles > 0 &&
+            maxCorrection <= GameConstants::ROCKET_SIZE, detail.str());
+    }
+    std::cout << std::endl;
+}
+
+// Wire format cost: bytes per snapshot and encode/decode rates
+void runSerialization(const BenchOptions& options) {
+    std::cout << "=== Serialization ===" << std::endl;
+    std::cout << std::left << std::setw(66) << "case" << std::right
+        << std::setw(12) << "us/call" << std::setw(12) << "ns/item" << std::endl;
+
+    for (int players : { 16, 64, 256 }) {
+        GameState state = makeSnapshot(players);
+        size_t entities = state.c.size() + state.d.size();
+
+        sf::Packet encoded;
+        encoded << state;
+        size_t bytes = encoded.getDataSize();
+        std::vector<char> wire(static_cast<const char*>(encoded.getData()),
+            static_cast<const char*>(encoded.getData()) + bytes);
+
+        double encodeSeconds = timePerCall([&]() {
+            sf::Packet packet;
+            packet << state;
+            benchSink = benchSink + static_cast<float>(packet.getDataSize());
+            }, options.minSeconds);
+        reportCase("serialization", "GameState encode",
+            { { "rockets", static_cast<double>(state.c.size()) }, { "planets", static_cast<double>(state.d.size()) },
+              { "bytes", static_cast<double>(bytes) }, { "MBps", bytes / encodeSeconds / 1e6 } },
+            encodeSeconds, static_cast<double>(entities));
+
+        GameState decoded;
+        double decodeSeconds = timePerCall([&]() {
+            sf::Packet packet;
+            packet.append(wire.data(), wire.size());
+            packet >> decoded;
+            benchSink = benchSink + decoded.b;
+            }, options.minSeconds);
+        reportCase("serialization", "GameState decode",
+            { { "rockets", static_cast<double>(state.c.size()) }, { "planets", static_cast<double>(state.d.size()) },
+              { "bytes", static_cast<double>(bytes) }, { "MBps", bytes / decodeSeconds / 1e6 } },
+            decodeSeconds, static_cast<double>(entities));
+    }
+
+    // Inputs arrive one per packet; time a batch so the clock isn't the cost
+    {
+        const int inputCount = 1024;
+        std::vector<PlayerInput> inputs(inputCount);
+        for (int i = 0; i < inputCount; i++) {
+            inputs[i].a = i;
+            inputs[i].b = (i % 2) == 0;
+            inputs[i].g = 0.5f;
+            inputs[i].l = static_cast<unsigned int>(i);
+        }
+
+        sf::Packet sample;
+        sample << inputs[0];
+        size_t bytes = sample.getDataSize();
+
+        std::vector<sf::Packet> packets(inputCount);
+        double encodeSeconds = timePerCall([&]() {
+            for (int i = 0; i < inputCount; i++) {
+                packets[i].clear();
+                packets[i] << inputs[i];
+            }
+            }, options.minSeconds);
+        reportCase("serialization", "PlayerInput encode",
+            { { "inputs", inputCount }, { "bytes", static_cast<double>(bytes) } }, encodeSeconds, inputCount);
+
+        PlayerInput decoded;
+        double decodeSeconds = timePerCall([&]() {
+            for (int i = 0; i < inputCount; i++) {
+                sf::Packet packet;
+                packet.append(packets[i].getData(), packets[i].getDataSize());
+                packet >> decoded;
+                benchSink = benchSink + decoded.g;
+            }
+            }, options.minSeconds);
+        reportCase("serialization", "PlayerInput decode",
+            { { "inputs", inputCount }, { "bytes", static_cast<double>(bytes) } }, decodeSeconds, inputCount);
+    }
+
+    // Rollback snapshots: each capture follows a real tick, so moving bodies
+    // differ from the previous capture and only the fixed rows share chunks
+    for (int players : { 16, 64, 256 }) {
+        ServerConfig config;
+        config.setMaxClients(players + 1);
+        config.setVerbose(false);
+        ServerLogger logger("bench_log.txt", false);
+        Log::ScopedSink logSink(logger);
+        GameServer server(logger, config);
+        populateServer(server, players);
+
+        size_t bytes = GameServer::rollbackBytes(server.getPlanets().size(), server.getPlayers().size());
+        RollbackStore store(64, bytes);
+        size_t entities = server.getPlanets().size() + server.getPlayers().size();
+
+        double captureSeconds = timePerCallWithSetup([&]() {
+            server.update(config.getUpdateRate());
+            }, [&]() {
+            server.captureRollback(store);
+            }, options.minSeconds);
+        double chunks = static_cast<double>(store.getChunksShared() + store.getChunksCopied());
+        reportCase("serialization", "GameServer::captureRollback",
+            { { "players", players }, { "bytes", static_cast<double>(bytes) },
+              { "sharedPercent", chunks > 0.0 ? 100.0 * store.getChunksShared() / chunks : 0.0 } },
+            captureSeconds, static_cast<double>(entities));
+
+        unsigned long tick = server.getSequenceNumber();
+        double restoreSeconds = timePerCall([&]() {
+            server.restoreRollback(store, tick);
+            }, options.minSeconds);
+        reportCase("serialization", "GameServer::restoreRollback",
+            { { "players", players }, { "bytes", static_cast<double>(bytes) } },
+            restoreSeconds, static_cast<double>(entities));
+    }
+
+    std::cout << std::endl;
+}
+
+// NetworkManager::sendGameState to N loopback sockets. Closed loop: each
+// snapshot is sent once every client has received the previous one, so the
+// rate is the sustained one and each latency is send start to last receive
+void runNetwork(const BenchOptions& options) {
+    std::cout << "=== Loopback network ===" << std::endl;
+    std::cout << std::left << std::setw(66) << "case" << std::right
+        << std::setw(12) << "us/call" << std::setw(12) << "ns/client" << std::endl;
+
+    ServerConfig config;
+    config.setVerbose(false);
+    config.setPort(options.port);
+    ServerLogger logger("bench_log.txt", false);
+    Log::ScopedSink logSink(logger);
+    ClientManager clientManager(logger, config);
+
+    GameState state = makeSnapshot(64);
+    std::vector<int> noCorrections;
+
+    for (int clientCount : { 1, 8, 32 }) {
+        NetworkManager network(clientManager, logger, config);
+        if (!network.hostGame(options.port)) {
+            std::cerr << "Could not listen on port " << options.port << ", skipping the network suite" << std::endl;
+            return;
+        }
+
+        std::vector<std::unique_ptr<sf::TcpSocket>> clients;
+        for (int i = 0; i < clientCount; i++) {
+            std::unique_ptr<sf::TcpSocket> client(new sf::TcpSocket());
+            if (client->connect(sf::IpAddress::LocalHost, options.port, sf::seconds(2)) != sf::Socket::Status::Done) {
+                std::cerr << "Loopback connect failed, skipping the network suite" << std::endl;
+                return;
+            }
+            clients.push_back(std::move(client));
+        }
+
+        // Accept everyone (each gets a PLAYER_ID first)
+        auto acceptDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        std::vector<ClientTraffic> traffic;
+        do {
+            network.update();
+            network.getClientTraffic(traffic);
+        } while (static_cast<int>(traffic.size()) < clientCount && std::chrono::steady_clock::now() < acceptDeadline);
+
+        // Blocking receive of the next GAME_STATE, skipping IDs and heartbeats
+        auto receiveSnapshot = [](sf::TcpSocket& client) {
+            sf::Packet packet;
+            while (client.receive(packet) == sf::Socket::Status::Done) {
+                uint32_t type = 0;
+                if (packet >> type && static_cast<MessageType>(type) == MessageType::GAME_STATE) return true;
+            }
+            return false;
+        };
+
+        std::vector<double> latencies;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        bool failed = false;
+        do {
+            auto sendStart = std::chrono::steady_clock::now();
+            network.sendGameState(state, noCorrections);
+            for (auto& client : clients) {
+                if (!receiveSnapshot(*client)) {
+                    failed = true;
+                    break;
+                }
+            }
+            auto received = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration<double>(received - sendStart).count());
+            elapsed = std::chrono::duration<double>(received - start).count();
+        } while (!failed && elapsed < options.minSeconds);
+
+        if (failed || latencies.empty()) {
+            std::cerr << "A loopback client lost its connection, skipping the rest of the network suite" << std::endl;
+            return;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto quantile = [&latencies](double q) {
+            return latencies[std::min(latencies.size() - 1, static_cast<size_t>(q * latencies.size()))];
+        };
+
+        double perSnapshot = elapsed / latencies.size();
+        reportCase("network", "NetworkManager::sendGameState",
+            { { "clients", clientCount }, { "rockets", static_cast<double>(state.c.size()) },
+              { "snapshotsPerSecond", 1.0 / perSnapshot },
+              { "p50us", quantile(0.50) * 1e6 }, { "p99us", quantile(0.99) * 1e6 }, { "maxUs", latencies.back() * 1e6 } },
+            perSnapshot, clientCount);
+
+        for (auto& client : clients) {
+            client->disconnect();
+        }
+        network.disconnect();
+    }
+
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    parseCommandLine(argc, argv, options);
+
+    bool all = options.suite == "all";
+
+    if (all || options.suite == "jobs") {
+        runJobScaling(options);
+    }
+
+    if (all || options.suite == "physics") {
+        runPhysics(options);
+    }
+
+    if (all || options.suite == "prediction") {
+        runPrediction(options);
+    }
+
+    if (all || options.suite == "serialization") {
+        runSerialization(options);
+    }
+
+    if (all || options.suite == "network") {
+        runNetwork(options);
+    }
+
+    if (!options.jsonFile.empty()) {
+        writeJson(options.jsonFile);
+    }
+
+    size_t failed = std::count_if(benchChecks.begin(), benchChecks.end(), [](const BenchCheck& check) { return !check.passed; });
+    if (failed > 0) {
+        std::cerr << failed << " of " << benchChecks.size() << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,291 @@
+// BotClient.cpp
+#include "BotClient.h"
+#include "GameClient.h"
+#include "NetworkManager.h"
+#include <iostream>
+
+namespace {
+    constexpr size_t SEND_TIME_SLOTS = 1024;
+    constexpr double SIMULATION_INTERVAL = 0.1; // Same as the client's sync interval
+}
+
+BotClient::BotClient(int index, BotScript script, float inputRate, bool predict)
+    : b(-1), c(script), d(static_cast<unsigned int>(index) * 7919u + 17u), e(1), f(0),
+    g(SEND_TIME_SLOTS, 0.0), h(0.0), i(0.0),
+    j(inputRate > 0.0f ? 1.0 / inputRate : 1.0 / 30.0),
+    l(false), m(0.0f), o(nullptr), p(false), q(), r(0.0), s(-1.0), t(-1.0), u(-1), v(-1)
+{
+    if (predict) {
+        try {
+            o = new GameClient();
+            o->initialize();
+        }
+        catch (const std::exception& ex) {
+            std::cerr << "Bot " << index << " failed to create predictor: " << ex.what() << std::endl;
+            delete o;
+            o = nullptr;
+        }
+    }
+}
+
+BotClient::~BotClient()
+{
+    disconnect();
+    delete o;
+    o = nullptr;
+}
+
+bool BotClient::connect(const sf::IpAddress& address, unsigned short port)
+{
+    a.setBlocking(true);
+    if (a.connect(address, port, sf::seconds(5)) != sf::Socket::Status::Done) {
+        return false;
+    }
+    a.setBlocking(false);
+    p = true;
+    return true;
+}
+
+void BotClient::disconnect()
+{
+    if (!p) return;
+
+    sf::Packet packet;
+    packet << static_cast<uint32_t>(static_cast<int>(MessageType::DISCONNECT));
+    a.setBlocking(true);
+    a.send(packet);
+    a.disconnect();
+    p = false;
+}
+
+bool BotClient::sendPacket(sf::Packet& packet)
+{
+    sf::Socket::Status status = a.send(packet);
+
+    // A non-blocking send can be cut short - the rest has to go out before anything else
+    while (status == sf::Socket::Status::Partial) {
+        status = a.send(packet);
+    }
+
+    if (status == sf::Socket::Status::Disconnected) {
+        p = false;
+    }
+    if (status != sf::Socket::Status::Done) {
+        n.d++;
+        return false;
+    }
+    return true;
+}
+
+void BotClient::update(double now)
+{
+    if (!p) return;
+
+    if (t < 0.0) {
+        t = now;
+        s = now;
+    }
+
+    // Drain everything the server has sent since the last update
+    sf::Packet packet;
+    sf::Socket::Status status;
+    while ((status = a.receive(packet)) == sf::Socket::Status::Done) {
+        handlePacket(packet, now);
+    }
+    if (status == sf::Socket::Status::Disconnected) {
+        p = false;
+        return;
+    }
+
+    // Step the headless client so it predicts like a real one
+    if (o) {
+        o->update(static_cast<float>(now - s));
+    }
+    s = now;
+
+    if (b < 0) return;
+
+    if (now >= h) {
+        chooseControls(now);
+        sendInput(now);
+        h = now + j;
+    }
+
+    if (now >= i) {
+        sendSimulation();
+        i = now + SIMULATION_INTERVAL;
+    }
+}
+
+void BotClient::handlePacket(sf::Packet& packet, double now)
+{
+    uint32_t msgType;
+    if (!(packet >> msgType)) return;
+
+    switch (static_cast<MessageType>(msgType)) {
+    case MessageType::PLAYER_ID:
+    {
+        uint32_t playerId;
+        if (packet >> playerId) {
+            b = static_cast<int>(playerId);
+            if (o) {
+                o->setLocalPlayerId(b);
+            }
+
+            // Lobby: ask for our room straight away
+            if (u >= 0) {
+                sf::Packet joinPacket;
+                joinPacket << static_cast<uint32_t>(static_cast<int>(MessageType::JOIN_ROOM)) << static_cast<uint32_t>(u);
+                sendPacket(joinPacket);
+            }
+        }
+        break;
+    }
+    case MessageType::ROOM_JOINED:
+    {
+        uint32_t roomId;
+        if (packet >> roomId) {
+            v = static_cast<int>(roomId);
+        }
+        break;
+    }
+    case MessageType::GAME_STATE:
+    {
+        size_t bytes = packet.getDataSize();
+        GameState state;
+        if (!(packet >> state)) break;
+
+        bool corrected = false;
+        if (!packet.endOfPacket() && !(packet >> corrected)) {
+            corrected = false;
+        }
+
+        n.a++;
+        n.e += bytes;
+        if (bytes > n.f) n.f = bytes;
+        if (corrected) n.b++;
+        m = state.b;
+
+        // Our rocket tells us which input the server has applied
+        for (const auto& rocket : state.c) {
+            if (rocket.a != b) continue;
+
+            k = rocket;
+            l = true;
+
+            if (static_cast<int>(rocket.k - f) > 0) {
+                double sentAt = g[rocket.k % SEND_TIME_SLOTS];
+                if (sentAt > 0.0) {
+                    n.g.push_back(static_cast<float>(now - sentAt));
+                }
+                f = rocket.k;
+            }
+            break;
+        }
+
+        if (o) {
+            if (corrected) {
+                state.e = true;
+                o->processServerValidation(state);
+            }
+            else {
+                o->processGameState(state);
+            }
+        }
+        break;
+    }
+    case MessageType::DISCONNECT:
+        p = false;
+        a.disconnect();
+        break;
+    default:
+        // Heartbeats and validation messages need no answer
+        break;
+    }
+}
+
+void BotClient::chooseControls(double now)
+{
+    switch (c) {
+    case BotScript::IDLE:
+        q = PlayerInput();
+        break;
+    case BotScript::ORBIT:
+    {
+        // Thrust one second in two, turn a little every third second
+        double elapsed = now - t;
+        q.b = static_cast<long long>(elapsed) % 2 == 0;
+        q.d = static_cast<long long>(elapsed) % 3 == 0;
+        q.g = 0.5f;
+        break;
+    }
+    case BotScript::RANDOM:
+        if (now >= r) {
+            std::uniform_int_distribution<int> coin(0, 3);
+            std::uniform_real_distribution<float> level(0.0f, 1.0f);
+            q.b = coin(d) == 0;
+            q.c = coin(d) == 0;
+            q.d = coin(d) == 0;
+            q.e = !q.d && coin(d) == 0;
+            q.g = level(d);
+            r = now + 0.5;
+        }
+        break;
+    }
+}
+
+void BotClient::sendInput(double now)
+{
+    float deltaTime = static_cast<float>(j);
+
+    PlayerInput input;
+    if (o && o->isConnected()) {
+        input = o->makePlayerInput(deltaTime);
+    }
+    else {
+        input.a = b;
+        input.h = deltaTime;
+        input.i = static_cast<float>(now - t);
+        input.j = m;
+        input.l = e++;
+    }
+
+    input.b = q.b;
+    input.c = q.c;
+    input.d = q.d;
+    input.e = q.e;
+    input.g = q.g;
+
+    if (o && o->isConnected()) {
+        o->applyLocalInput(input);
+    }
+
+    sf::Packet packet;
+    packet << static_cast<uint32_t>(static_cast<int>(MessageType::PLAYER_INPUT)) << input;
+    if (sendPacket(packet)) {
+        g[input.l % SEND_TIME_SLOTS] = now;
+        n.c++;
+    }
+}
+
+void BotClient::sendSimulation()
+{
+    GameState simulation;
+    if (o && o->isConnected()) {
+        simulation = o->getLocalSimulation();
+    }
+    else if (l) {
+        // Without a predictor, report back what the server last told us
+        simulation.a = 0;
+        simulation.b = m;
+        simulation.e = false;
+        simulation.c.push_back(k);
+    }
+    else {
+        return;
+    }
+
+    sf::Packet packet;
+    packet << static_cast<uint32_t>(static_cast<int>(MessageType::CLIENT_SIMULATION)) << simulation;
+    sendPacket(packet);
+}
\ No newline at end of file
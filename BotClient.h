@@ -0,0 +1,83 @@
+// BotClient.h
+#pragma once
+#include <SFML/Network.hpp>
+#include <vector>
+#include <random>
+#include <cstddef>
+#include "GameState.h"
+#include "PlayerInput.h"
+
+class GameClient;
+
+// How a bot picks its controls
+enum class BotScript {
+    IDLE,    // Never touches the controls
+    ORBIT,   // Fixed thrust/turn pattern, identical for every bot
+    RANDOM   // Random controls, re-rolled every half second from a per-bot seed
+};
+
+// Numbers a bot collects while it runs
+struct BotStats {
+    unsigned long a; // snapshotsReceived
+    unsigned long b; // correctionsReceived
+    unsigned long c; // inputsSent
+    unsigned long d; // sendFailures
+    unsigned long long e; // snapshotBytes - total payload of received snapshots
+    size_t f; // largestSnapshot
+    std::vector<float> g; // latencies - seconds from sending an input to seeing it acknowledged
+
+    BotStats() : a(0), b(0), c(0), d(0), e(0), f(0) {}
+};
+
+// Headless player: speaks the game protocol over its own socket and never
+// opens a window. Optionally drives a full GameClient so prediction and
+// reconciliation run exactly as they do in the real client.
+class BotClient {
+private:
+    sf::TcpSocket a; // socket
+    int b; // playerId - -1 until the server assigns one
+    BotScript c; // script
+    std::mt19937 d; // rng
+    unsigned int e; // nextInputSequence - used when there is no GameClient
+    unsigned int f; // lastAcknowledged - newest input sequence the server has echoed
+    std::vector<double> g; // sendTimes - when each input went out, indexed by sequence
+    double h; // nextInputTime
+    double i; // nextSimulationTime
+    double j; // inputInterval
+    RocketState k; // ownState - our rocket in the newest snapshot
+    bool l; // hasOwnState
+    float m; // serverTime - timestamp of the newest snapshot
+    BotStats n; // stats
+    GameClient* o; // predictor - optional headless GameClient
+    bool p; // connected
+    PlayerInput q; // controls - current scripted controls
+    double r; // nextControlChange
+    double s; // lastUpdateTime
+    double t; // startTime
+    int u; // requestedRoom - room to ask for after connecting, -1 to stay where the server puts us
+    int v; // room - room the server says we are in
+
+    void handlePacket(sf::Packet& packet, double now);
+    void chooseControls(double now);
+    void sendInput(double now);
+    void sendSimulation();
+    bool sendPacket(sf::Packet& packet);
+
+public:
+    BotClient(int index, BotScript script, float inputRate, bool predict);
+    ~BotClient();
+
+    bool connect(const sf::IpAddress& address, unsigned short port);
+    void disconnect();
+
+    // Drain incoming packets and send whatever is due - never blocks
+    void update(double now);
+
+    void setRequestedRoom(int roomId) { u = roomId; }
+    int getRoom() const { return v; }
+
+    bool isConnected() const { return p; }
+    int getPlayerId() const { return b; }
+    const BotStats& getStats() const { return n; }
+    const GameClient* getPredictor() const { return o; }
+};
\ No newline at end of file
@@ -0,0 +1,81 @@
+// DeterministicMath.h
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Replacements for the libm calls the simulation makes. std::sqrt is
+// correctly rounded everywhere, but std::pow, std::sin and std::cos are not:
+// MSVC, glibc and the client platforms may differ in the last bit, which is
+// enough to split two simulations of the same inputs apart. These use only
+// + - * / and exact conversions, so they give the same bits on every IEEE
+// platform as long as the compiler doesn't contract them into FMAs
+// (/fp:precise on MSVC, -ffp-contract=off on GCC/Clang).
+namespace DeterministicMath {
+    constexpr double PI = 3.14159265358979323846;
+
+    // Cube root; accurate to well under a float ulp
+    inline float cubeRoot(float value) {
+        if (value == 0.0f) return 0.0f;
+        if (value < 0.0f) return -cubeRoot(-value);
+
+        // Divide the exponent by three for a first guess within a few percent
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits = bits / 3 + 709921077u;
+        float guess;
+        std::memcpy(&guess, &bits, sizeof(guess));
+
+        // Newton steps in double; each squares the relative error
+        double x = value;
+        double y = guess;
+        for (int i = 0; i < 4; i++) {
+            y = y - (y * y * y - x) / (3.0 * y * y);
+        }
+        return static_cast<float>(y);
+    }
+
+    namespace detail {
+        // Taylor series on [-pi/4, pi/4]; the error is below 1e-12
+        inline double sinKernel(double r) {
+            double r2 = r * r;
+            return r * (1.0 + r2 * (-1.0 / 6.0 + r2 * (1.0 / 120.0 + r2 * (-1.0 / 5040.0 +
+                r2 * (1.0 / 362880.0 + r2 * (-1.0 / 39916800.0 + r2 * (1.0 / 6227020800.0)))))));
+        }
+
+        inline double cosKernel(double r) {
+            double r2 = r * r;
+            return 1.0 + r2 * (-1.0 / 2.0 + r2 * (1.0 / 24.0 + r2 * (-1.0 / 720.0 +
+                r2 * (1.0 / 40320.0 + r2 * (-1.0 / 3628800.0 + r2 * (1.0 / 479001600.0))))));
+        }
+
+        // Split radians into a quarter turn count and a remainder in [-pi/4, pi/4]
+        inline double reduce(double radians, int64_t& quadrant) {
+            double turns = radians * (2.0 / PI);
+            double nearest = static_cast<double>(static_cast<int64_t>(turns < 0.0 ? turns - 0.5 : turns + 0.5));
+            quadrant = static_cast<int64_t>(nearest);
+            return radians - nearest * (PI / 2.0);
+        }
+    }
+
+    inline float sine(float radians) {
+        int64_t quadrant;
+        double r = detail::reduce(radians, quadrant);
+        switch (quadrant & 3) {
+        case 0:  return static_cast<float>(detail::sinKernel(r));
+        case 1:  return static_cast<float>(detail::cosKernel(r));
+        case 2:  return static_cast<float>(-detail::sinKernel(r));
+        default: return static_cast<float>(-detail::cosKernel(r));
+        }
+    }
+
+    inline float cosine(float radians) {
+        int64_t quadrant;
+        double r = detail::reduce(radians, quadrant);
+        switch (quadrant & 3) {
+        case 0:  return static_cast<float>(detail::cosKernel(r));
+        case 1:  return static_cast<float>(-detail::sinKernel(r));
+        case 2:  return static_cast<float>(-detail::cosKernel(r));
+        default: return static_cast<float>(detail::sinKernel(r));
+        }
+    }
+}
\ No newline at end of file
@@ -23,8 +23,14 @@ GameClient::GameClient()
     o(false), // simulationPaused
     p(0.0f), // lastServerSyncTime
     q(0.1f), // syncInterval
-    r(false) // pendingValidation
+    r(false), // pendingValidation
+    s(), // prediction
+    t(), // playoutClock
+    u() // arrivalClock
 {
+    // Step planets the way the server does, so between snapshots they drift
+    // from where the server has them as little as possible
+    a.setBlockTimesteps(true);
 }
 
 GameClient::~GameClient()
@@ -103,8 +109,8 @@ void GameClient::initialize()
             throw;
         }
 
-        // Add to simulator
-        a.addVehicleManager(d);
+        // The local player is stepped by stepLocalPlayer rather than the simulator,
+        // so a replay after a correction runs exactly the same code
 
         // Initialize local simulation
         initializeLocalSimulation();
@@ -186,27 +192,34 @@ void GameClient::update(float deltaTime)
         // Update simulator with null checking
         a.update(deltaTime);
 
-        // Update planets with null checking
-        for (auto planet : b) {
-            if (planet) {
-                planet->update(deltaTime);
+        // Update planets with null checking, unless the simulator already moved them in its substeps
+        if (!a.getBlockTimesteps()) {
+            for (auto planet : b) {
+                if (planet) {
+                    planet->update(deltaTime);
+                }
             }
         }
 
-        // Update local player with null checking
+        // Update local player and remember what we predicted for this frame
         if (d) {
-            d->update(deltaTime);
+            stepLocalPlayer(deltaTime);
+
+            RocketState predicted;
+            d->createState(predicted);
+            s.pushFrame(deltaTime, predicted);
         }
 
         // Update remote players with null checking
         for (auto& player : c) {
             if (player.second) {
+                player.second->updatePlanets(a.getPlanets(), a.getPlanetVersion());
                 player.second->update(deltaTime);
             }
         }
 
         // Interpolate remote players for smooth movement
-        interpolateRemotePlayers(n);
+        interpolateRemotePlayers(u.getElapsedTime().asSeconds());
 
         // Check if it's time to sync with server
         if (m.getElapsedTime().asSeconds() >= q && !o && !r) {
@@ -326,6 +339,9 @@ void GameClient::processGameState(const GameState& state)
         f = state;
         g = state.b;
 
+        // Track arrival timing to size the remote player playout delay
+        t.onSnapshot(u.getElapsedTime().asSeconds(), state.b);
+
         // Update connection state if this is our first state
         if (!k) {
             std::cout << "Received initial game state with " << state.d.size() << " planets and "
@@ -381,7 +397,6 @@ void GameClient::processGameState(const GameState& state)
                     sf::Vector2f initialPos = b[0]->getPosition() +
                         sf::Vector2f(0, -(b[0]->getRadius() + GameConstants::ROCKET_SIZE));
                     d = new VehicleManager(initialPos, b, e);
-                    a.addVehicleManager(d);
                     std::cout << "Created local player (was null)" << std::endl;
                 }
                 catch (const std::exception& ex) {
@@ -398,7 +413,6 @@ void GameClient::processGameState(const GameState& state)
                         // Create local player if it doesn't exist
                         try {
                             d = new VehicleManager(rocketState.b, b, e);
-                            a.addVehicleManager(d);
                             std::cout << "Created local player with ID: " << e << std::endl;
 
                             // Verify the rocket was actually created
@@ -418,10 +432,9 @@ void GameClient::processGameState(const GameState& state)
                         }
                     }
 
-                    // Apply the server state to our local rocket
+                    // Rewind to the server state and replay inputs it hasn't seen yet
                     if (d && d->getRocket()) {
-                        d->applyState(rocketState);
-                        std::cout << "Updated local rocket position: " << rocketState.b.x << ", " << rocketState.b.y << std::endl;
+                        reconcileLocalPlayer(rocketState);
                     }
                     else {
                         std::cerr << "ERROR: Local player exists but rocket is null after state update" << std::endl;
@@ -461,27 +474,16 @@ void GameClient::processGameState(const GameState& state)
                     remotePlayer = it->second;
                 }
 
-                // Update rocket state with interpolation if manager exists
+                // Queue the state for interpolation if manager exists
                 if (remotePlayer && remotePlayer->getRocket()) {
-                    Rocket* rocket = remotePlayer->getRocket();
-
-                    // Store previous position for interpolation
-                    sf::Vector2f prevPos = rocket->getPosition();
-                    sf::Vector2f prevVel = rocket->getVelocity();
-
-                    // Update with server values
-                    rocket->setPosition(rocketState.b);
-                    rocket->setVelocity(rocketState.c);
-                    rocket->setRotation(rocketState.d);
-                    rocket->setThrustLevel(rocketState.f);
-
-                    // Store for interpolation
-                    h[rocketState.a] = {
-                        prevPos, prevVel,
-                        rocketState.b, rocketState.c,
-                        rocketState.d,
-                        state.b
-                    };
+                    remotePlayer->getRocket()->setThrustLevel(rocketState.f);
+
+                    RemoteSnapshot snapshot;
+                    snapshot.a = state.b; // serverTime
+                    snapshot.b = rocketState.b; // position
+                    snapshot.c = rocketState.c; // velocity
+                    snapshot.d = rocketState.d; // rotation
+                    h[rocketState.a].push(snapshot);
                 }
             }
         }
@@ -540,28 +542,22 @@ void GameClient::setLocalPlayerId(int id)
     a.setOwnerId(id);
 }
 
-PlayerInput GameClient::getLocalPlayerInput(float deltaTime) const
+PlayerInput GameClient::makePlayerInput(float deltaTime) const
 {
     PlayerInput input;
     input.a = e; // playerId
     input.h = deltaTime; // deltaTime
     input.i = n; // clientTimestamp
     input.j = g; // lastServerStateTimestamp
+    input.l = s.peekSequence(); // inputSequence
 
-    // Skip input collection if not fully connected
+    // Skip state collection if not fully connected
     if (j != ClientConnectionState::CONNECTED || !k || !d) {
         return input;
     }
 
-    // Get keyboard state
-    input.b = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W); // thrustForward
-    input.c = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S); // thrustBackward
-    input.d = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A); // rotateLeft
-    input.e = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D); // rotateRight
-    input.f = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::L); // switchVehicle
-
     // Get thrust level
-    if (d && d->getActiveVehicleType() == VehicleType::ROCKET && d->getRocket()) {
+    if (d->getActiveVehicleType() == VehicleType::ROCKET && d->getRocket()) {
         input.g = d->getRocket()->getThrustLevel(); // thrustLevel
 
         // Include current rocket state
@@ -575,6 +571,25 @@ PlayerInput GameClient::getLocalPlayerInput(float deltaTime) const
     return input;
 }
 
+PlayerInput GameClient::getLocalPlayerInput(float deltaTime) const
+{
+    PlayerInput input = makePlayerInput(deltaTime);
+
+    // Skip input collection if not fully connected
+    if (j != ClientConnectionState::CONNECTED || !k || !d) {
+        return input;
+    }
+
+    // Get keyboard state
+    input.b = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W); // thrustForward
+    input.c = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S); // thrustBackward
+    input.d = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A); // rotateLeft
+    input.e = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D); // rotateRight
+    input.f = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::L); // switchVehicle
+
+    return input;
+}
+
 void GameClient::applyLocalInput(const PlayerInput& input)
 {
     // Skip if not fully connected or no local player
@@ -583,33 +598,74 @@ void GameClient::applyLocalInput(const PlayerInput& input)
     }
 
     try {
-        // Apply input to local player immediately for responsive feel
-        if (input.b) {
-            d->applyThrust(1.0f);
-        }
-        if (input.c) {
-            d->applyThrust(-0.5f);
-        }
-        if (input.d) {
-            d->rotate(-6.0f * input.h * 60.0f);
-        }
-        if (input.e) {
-            d->rotate(6.0f * input.h * 60.0f);
-        }
-        if (input.f) {
-            d->switchVehicle();
+        // Two inputs in one frame - close the first as a zero-length frame so it still replays
+        if (s.hasStagedInput()) {
+            RocketState current;
+            d->createState(current);
+            s.pushFrame(0.0f, current);
         }
 
-        // Apply thrust level
-        if (d->getActiveVehicleType() == VehicleType::ROCKET && d->getRocket()) {
-            d->getRocket()->setThrustLevel(input.g);
-        }
+        // Apply input to local player immediately for responsive feel
+        d->applyInput(input);
+
+        // Keep it until the server acknowledges it
+        s.stageInput(input);
     }
     catch (const std::exception& ex) {
         std::cerr << "Exception in applyLocalInput: " << ex.what() << std::endl;
     }
 }
 
+void GameClient::stepLocalPlayer(float deltaTime)
+{
+    if (!d) return;
+
+    // Only copies when planets were added or merged since the last step
+    d->updatePlanets(a.getPlanets(), a.getPlanetVersion());
+
+    if (d->getActiveVehicleType() == VehicleType::ROCKET) {
+        a.applyGravityToRocket(d->getRocket(), deltaTime);
+    }
+    d->update(deltaTime);
+}
+
+void GameClient::reconcileLocalPlayer(const RocketState& serverState)
+{
+    Rocket* rocket = d ? d->getRocket() : nullptr;
+    if (!rocket || d->getActiveVehicleType() != VehicleType::ROCKET) return;
+
+    sf::Vector2f predictedPos = rocket->getPosition();
+
+    // Frames up to the acknowledged input are already part of the server state
+    s.acknowledge(serverState.k);
+
+    // Rewind to the authoritative state
+    rocket->setPosition(serverState.b);
+    rocket->setVelocity(serverState.c);
+    rocket->setRotation(serverState.d);
+    rocket->setAngularVelocity(serverState.e);
+    rocket->setThrustLevel(serverState.f);
+    rocket->setMass(serverState.g);
+
+    // Replay everything the server hasn't seen yet
+    for (size_t index = 0; index < s.size(); index++) {
+        PredictionFrame& frame = s.at(index);
+        if (frame.b) {
+            d->applyInput(frame.a);
+        }
+        stepLocalPlayer(frame.c);
+        d->createState(frame.d);
+    }
+
+    // An input applied this frame but not yet stepped was wiped by the rewind
+    if (s.hasStagedInput()) {
+        d->applyInput(s.getStagedInput());
+    }
+
+    // How far the prediction was off
+    s.recordCorrection(distance(predictedPos, rocket->getPosition()));
+}
+
 void GameClient::interpolateRemotePlayers(float currentTime)
 {
     // Skip if not fully connected
@@ -617,10 +673,13 @@ void GameClient::interpolateRemotePlayers(float currentTime)
         return;
     }
 
+    // Server time remote players are drawn at - behind the newest snapshot by the playout delay
+    float renderTime = t.renderTime(currentTime, i);
+
     try {
         for (auto it = h.begin(); it != h.end();) {
             int playerId = it->first;
-            RemotePlayerState& playerState = it->second;
+            const SnapshotBuffer& snapshots = it->second;
 
             auto playerIt = c.find(playerId);
             if (playerIt == c.end() || !playerIt->second || !playerIt->second->getRocket()) {
@@ -636,17 +695,17 @@ void GameClient::interpolateRemotePlayers(float currentTime)
                 continue;
             }
 
-            // Calculate interpolation factor
-            float timeDiff = currentTime - playerState.f;
-            float factor = std::min(timeDiff / i, 1.0f);
-
-            // Interpolate position and velocity
-            sf::Vector2f pos = playerState.a + (playerState.c - playerState.a) * factor;
-            sf::Vector2f vel = playerState.b + (playerState.d - playerState.b) * factor;
+            // Hermite between surrounding snapshots, bounded extrapolation past the newest
+            RemoteSnapshot sampled;
+            if (!snapshots.sample(renderTime, GameConstants::MAX_EXTRAPOLATION, sampled)) {
+                ++it;
+                continue;
+            }
 
             try {
-                rocket->setPosition(pos);
-                rocket->setVelocity(vel);
+                rocket->setPosition(sampled.b);
+                rocket->setVelocity(sampled.c);
+                rocket->setRotation(sampled.d);
             }
             catch (const std::exception& ex) {
                 std::cerr << "Exception in interpolateRemotePlayers: " << ex.what() << std::endl;
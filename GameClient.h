@@ -4,6 +4,8 @@
 #include "VehicleManager.h"
 #include "GameState.h"
 #include "PlayerInput.h"
+#include "PredictionBuffer.h"
+#include "SnapshotInterpolator.h"
 #include <vector>
 #include <map>
 #include <SFML/Graphics.hpp>
@@ -16,16 +18,6 @@ enum class ClientConnectionState {
     CONNECTED
 };
 
-// Struct to store interpolation data for remote players
-struct RemotePlayerState {
-    sf::Vector2f a; // startPos
-    sf::Vector2f b; // startVel
-    sf::Vector2f c; // targetPos
-    sf::Vector2f d; // targetVel
-    float e; // rotation
-    float f; // timestamp
-};
-
 class GameClient {
 private:
     GravitySimulator a; // simulator
@@ -39,8 +31,8 @@ private:
     float g; // stateTimestamp
 
     // Interpolation data for remote players
-    std::map<int, RemotePlayerState> h; // remotePlayerStates
-    float i; // latencyCompensation - time window for interpolation
+    std::map<int, SnapshotBuffer> h; // remotePlayerSnapshots - recent server states per remote player
+    float i; // latencyCompensation - minimum playout delay for interpolation
 
     // Connection state tracking
     ClientConnectionState j; // connectionState
@@ -55,6 +47,19 @@ private:
     float q; // syncInterval - how often to send simulation to server
     bool r; // pendingValidation - waiting for server validation
 
+    // Client-side prediction
+    PredictionBuffer s; // prediction - unacknowledged inputs and the states they produced
+
+    // Remote player playout timing
+    PlayoutClock t; // playoutClock - adaptive delay from measured snapshot jitter
+    sf::Clock u; // arrivalClock - local time base for snapshot arrivals
+
+    // Advance the local player by one frame (gravity + integration), same as the server
+    void stepLocalPlayer(float deltaTime);
+
+    // Rewind the local rocket to an authoritative state and replay pending inputs
+    void reconcileLocalPlayer(const RocketState& serverState);
+
 public:
     GameClient();
     ~GameClient();
@@ -65,10 +70,14 @@ public:
     void processGameState(const GameState& state);
     PlayerInput getLocalPlayerInput(float deltaTime) const;
 
+    // Input with everything but the controls filled in - for headless clients that
+    // choose their own controls instead of reading the keyboard
+    PlayerInput makePlayerInput(float deltaTime) const;
+
     // Apply input locally for responsive control
     void applyLocalInput(const PlayerInput& input);
 
-    // Interpolate remote players between received states
+    // Interpolate remote players between received states (currentTime on the arrival clock)
     void interpolateRemotePlayers(float currentTime);
 
     // New methods for distributed simulation
@@ -92,4 +101,8 @@ public:
     bool isConnected() const { return j == ClientConnectionState::CONNECTED && k; }
     bool isWaitingForState() const { return j == ClientConnectionState::WAITING_FOR_STATE; }
     bool isPendingValidation() const { return r; }
+
+    // Prediction diagnostics
+    const PredictionBuffer& getPrediction() const { return s; }
+    const PlayoutClock& getPlayoutClock() const { return t; }
 };
\ No newline at end of file
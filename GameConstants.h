@@ -1,6 +1,7 @@
 // GameConstants.h
 #pragma once
 #include <cmath>
+#include "DeterministicMath.h"
 #include <SFML/Graphics.hpp>
 namespace GameConstants {
     // Gravitational constants
@@ -27,7 +28,7 @@ namespace GameConstants {
     constexpr float MAIN_PLANET_Y = 300.0f;
 
     // Non-constexpr calculations for orbital parameters
-    const float PLANET_ORBIT_DISTANCE = std::pow((G * MAIN_PLANET_MASS * ORBIT_PERIOD * ORBIT_PERIOD) / (4.0f * PI * PI), 1.0f / 3.0f);
+    const float PLANET_ORBIT_DISTANCE = DeterministicMath::cubeRoot((G * MAIN_PLANET_MASS * ORBIT_PERIOD * ORBIT_PERIOD) / (4.0f * PI * PI));
 
     // Secondary planet position based on orbital distance
     const float SECONDARY_PLANET_X = MAIN_PLANET_X + PLANET_ORBIT_DISTANCE;
@@ -39,6 +40,8 @@ namespace GameConstants {
     // Rocket parameters
     constexpr float ROCKET_MASS = 1.0f;
     constexpr float ROCKET_SIZE = 15.0f;
+    constexpr int ROCKET_COLLISION_SUBSTEPS = 4;  // Most planet contacts resolved within one rocket update
+    constexpr float ROCKET_CONTACT_SKIN = 0.05f;  // Gap left above a surface after a contact
 
     // Trajectory calculation settings
     constexpr float TRAJECTORY_TIME_STEP = 0.05f;
@@ -50,6 +53,21 @@ namespace GameConstants {
     constexpr float TRANSFORM_DISTANCE = 40.0f;
     constexpr float TRANSFORM_VELOCITY_FACTOR = 0.1f;
 
+    // Block timesteps: a planet takes 2^level substeps per update, the fewest
+    // that keep each step under ETA times its |acceleration| / |jerk|
+    constexpr float BLOCK_TIMESTEP_ETA = 0.05f;
+    constexpr int MAX_BLOCK_TIMESTEP_LEVEL = 6;  // At most 64 substeps per update
+
+    // Planet spatial index
+    constexpr float PLANET_INDEX_CELL_SIZE = 512.0f;  // About twice the largest planet's diameter
+    constexpr size_t PLANET_INDEX_BUCKETS = 1024;  // Hash table size, a power of two
+
+    // Remote player interpolation
+    constexpr float MIN_PLAYOUT_DELAY = 0.02f;  // Lower bound for the adaptive playout delay
+    constexpr float MAX_PLAYOUT_DELAY = 0.5f;  // Upper bound for the adaptive playout delay
+    constexpr float PLAYOUT_JITTER_FACTOR = 3.0f;  // Jitter multiples added to the snapshot interval
+    constexpr float MAX_EXTRAPOLATION = 0.25f;  // Longest time to extrapolate past the newest snapshot
+
     // Engine parameters
     constexpr float BASE_THRUST_MULTIPLIER = 1.875f;
     constexpr float ENGINE_THRUST_POWER = G * BASE_THRUST_MULTIPLIER;
@@ -60,6 +78,17 @@ namespace GameConstants {
     // Server specific constants
     constexpr unsigned short DEFAULT_PORT = 5000;
     constexpr float SERVER_UPDATE_RATE = 0.05f;  // 20 updates per second
+    constexpr int MAX_CATCH_UP_STEPS = 5;  // Most simulation steps one server frame may run when behind
+    constexpr int ROOM_NETWORK_POLLS_PER_TICK = 10;  // How often the multi-room network thread routes input per tick
     constexpr int MAX_CLIENTS = 16;  // Maximum number of clients
     constexpr float CLIENT_TIMEOUT = 5.0f;  // Timeout in seconds
+    constexpr float STATE_HISTORY_WINDOW = 2.0f;  // Seconds of past states kept for lag compensation
+    constexpr float CORRECTION_INTERVAL = 0.25f;  // Minimum seconds between corrections to one client
+
+    // Job sizes for the parallel tick loops
+    constexpr size_t PLANETS_PER_JOB = 4;
+    constexpr size_t PLAYERS_PER_JOB = 16;
+    constexpr size_t VALIDATIONS_PER_JOB = 32;
+    constexpr size_t SNAPSHOT_ROCKETS_PER_JOB = 64;
+    constexpr size_t GRAVITY_ROCKETS_PER_JOB = 256;  // Multiple of the batch width; smaller batches run inline
 }
\ No newline at end of file
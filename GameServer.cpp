@@ -1,16 +1,111 @@
 // GameServer.cpp
 #include "GameServer.h"
 #include "GameConstants.h"
-#include <iostream>
+#include "Log.h"
+#include "TickProfiler.h"
+#include "DeterministicMath.h"
 #include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+namespace {
+    // Rollback buffer layout: a header, then the fields of each body that
+    // rarely change, then the ones that change every tick. Keeping all the
+    // rarely-changing rows together lets RollbackStore share their chunks
+    struct RollbackHeader {
+        uint64_t sequenceNumber;
+        float gameTime;
+        uint32_t planetCount;
+        uint32_t playerCount;
+        uint32_t stepsHeld;     // planet motion rows carry the simulator's held acceleration and jerk
+    };
+
+    struct RollbackPlanetFixed {
+        float mass;
+        float radius;
+        int32_t ownerId;
+        uint32_t color;
+    };
+
+    struct RollbackPlayerFixed {
+        int32_t playerId;
+        uint32_t color;
+        float mass;
+        float storedMass;
+    };
+
+    struct RollbackPlanetMotion {
+        float positionX;
+        float positionY;
+        float velocityX;
+        float velocityY;
+        float accelerationX;
+        float accelerationY;
+        float jerkX;
+        float jerkY;
+    };
+
+    struct RollbackPlayerMotion {
+        float positionX;
+        float positionY;
+        float velocityX;
+        float velocityY;
+        float rotation;
+        float angularVelocity;
+        float thrustLevel;
+        float timestamp;
+        uint32_t lastInputSequence;
+    };
+
+    // Rows are copied with memcpy, so the buffer needs no particular alignment
+    template<typename T>
+    void writeRow(std::vector<char>& buffer, size_t& offset, const T& row) {
+        std::memcpy(buffer.data() + offset, &row, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    template<typename T>
+    void readRow(const std::vector<char>& buffer, size_t& offset, T& row) {
+        std::memcpy(&row, buffer.data() + offset, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    // Put a saved rocket back into a player's vehicle manager
+    void restoreRocket(VehicleManager* player, const WorldPlayerRecord& record) {
+        Rocket* rocket = player->getRocket();
+        if (!rocket) return;
+
+        rocket->setPosition(sf::Vector2f(record.positionX, record.positionY));
+        rocket->setVelocity(sf::Vector2f(record.velocityX, record.velocityY));
+        rocket->setRotation(record.rotation);
+        rocket->setAngularVelocity(record.angularVelocity);
+        rocket->setThrustLevel(record.thrustLevel);
+        rocket->addStoredMass(record.storedMass - rocket->getStoredMass());
+        rocket->setMass(record.mass);
+        rocket->setLastStateTimestamp(record.timestamp);
+        rocket->setColor(sf::Color(record.color));
+        player->setLastStateTimestamp(record.timestamp);
+    }
+}
+
 GameServer::GameServer(ServerLogger& logger, ServerConfig& config)
-    : e(0), f(0.0f), j(0.1f), s(logger), t(config) // Add the references to logger and config
+    : e(0), f(0.0f), j(0.1f), s(logger), t(config), // Add the references to logger and config
+    k(GameConstants::STATE_HISTORY_WINDOW, config.getUpdateRate(), config.getMaxClients() + 1),
+    o(GameConstants::CORRECTION_INTERVAL), p(0), q(0), r(0), u(0), v(0), x(nullptr), aa(), ad(0)
 {
-    // Constructor implementation
+    // Rockets are pulled in update once the planets have moved, not inside the simulator step
+    c.setSimulateVehicleGravity(false);
+
+    // Planets in close passes take extra substeps; the simulator moves them itself
+    c.setBlockTimesteps(true);
 }
 
 GameServer::~GameServer()
 {
+    ServerMetrics::global().retract(aa);
+
     // Clean up players
     for (auto& player : b) {
         delete player.second;
@@ -57,15 +152,15 @@ void GameServer::initialize()
         float angle = (i * 40.0f) * (3.14159f / 180.0f); // Distribute planets around the sun
 
         // Calculate position based on orbit distance and angle
-        float posX = mainPlanet->getPosition().x + orbitDistance * cos(angle);
-        float posY = mainPlanet->getPosition().y + orbitDistance * sin(angle);
+        float posX = mainPlanet->getPosition().x + orbitDistance * DeterministicMath::cosine(angle);
+        float posY = mainPlanet->getPosition().y + orbitDistance * DeterministicMath::sine(angle);
 
         // Calculate orbital velocity for a circular orbit
         float orbitalVelocity = std::sqrt(GameConstants::G * mainPlanet->getMass() / orbitDistance);
 
         // Velocity is perpendicular to position vector
-        float velX = -sin(angle) * orbitalVelocity;
-        float velY = cos(angle) * orbitalVelocity;
+        float velX = -DeterministicMath::sine(angle) * orbitalVelocity;
+        float velY = DeterministicMath::cosine(angle) * orbitalVelocity;
 
         // Create the planet with scaled mass
         Planet* newPlanet = new Planet(
@@ -82,37 +177,357 @@ void GameServer::initialize()
         c.addPlanet(planet);
     }
 
+    addHostPlayer();
+}
+
+void GameServer::addHostPlayer()
+{
+    ac.rebuild(a);
+
     // Create a default host player (ID 0)
     sf::Vector2f spawnPos = a[0]->getPosition() +
         sf::Vector2f(0, -(a[0]->getRadius() + GameConstants::ROCKET_SIZE));
     addPlayer(0, spawnPos, sf::Color::White);
 }
 
+bool GameServer::restoreWorld(const MappedWorld& world)
+{
+    if (!world.isOpen() || world.planetCount() == 0) return false;
+
+    // Records are read in place from the mapping; planets keep their saved order
+    const WorldPlanetRecord* planets = world.planets();
+    for (size_t index = 0; index < world.planetCount(); index++) {
+        const WorldPlanetRecord& record = planets[index];
+        Planet* planet = new Planet(sf::Vector2f(record.positionX, record.positionY),
+            record.radius, record.mass, sf::Color(record.color));
+        planet->setVelocity(sf::Vector2f(record.velocityX, record.velocityY));
+        planet->setOwnerId(record.ownerId);
+        a.push_back(planet);
+    }
+
+    c.setSimulatePlanetGravity(true);
+    for (auto planet : a) {
+        c.addPlanet(planet);
+    }
+
+    e = static_cast<unsigned long>(world.header().sequenceNumber);
+    f = world.header().gameTime;
+
+    const WorldPlayerRecord* players = world.players();
+    for (size_t index = 0; index < world.playerCount(); index++) {
+        ab[players[index].playerId] = players[index];
+    }
+
+    addHostPlayer();
+
+    KLOG_INFO(GAME, "world_restored", "planets", a.size(), "saved_players", world.playerCount(),
+        "sequence", e, "game_time", f);
+    return true;
+}
+
+void GameServer::captureWorld(WorldSnapshot& out) const
+{
+    out.sequenceNumber = e;
+    out.gameTime = f;
+
+    out.planets.clear();
+    for (const Planet* planet : a) {
+        if (!planet) continue;
+
+        WorldPlanetRecord record;
+        record.positionX = planet->getPosition().x;
+        record.positionY = planet->getPosition().y;
+        record.velocityX = planet->getVelocity().x;
+        record.velocityY = planet->getVelocity().y;
+        record.mass = planet->getMass();
+        record.radius = planet->getRadius();
+        record.ownerId = planet->getOwnerId();
+        record.color = planet->getColor().toInteger();
+        out.planets.push_back(record);
+    }
+
+    out.players.clear();
+    for (const auto& playerPair : b) {
+        const Rocket* rocket = playerPair.second ? playerPair.second->getRocket() : nullptr;
+        if (!rocket) continue;
+
+        WorldPlayerRecord record;
+        record.playerId = playerPair.first;
+        record.positionX = rocket->getPosition().x;
+        record.positionY = rocket->getPosition().y;
+        record.velocityX = rocket->getVelocity().x;
+        record.velocityY = rocket->getVelocity().y;
+        record.rotation = rocket->getRotation();
+        record.angularVelocity = rocket->getAngularVelocity();
+        record.thrustLevel = rocket->getThrustLevel();
+        record.mass = rocket->getMass();
+        record.storedMass = rocket->getStoredMass();
+        record.timestamp = rocket->getLastStateTimestamp();
+        record.color = rocket->getColor().toInteger();
+        out.players.push_back(record);
+    }
+
+    // Saved players who haven't rejoined yet carry over to the next file
+    for (const auto& saved : ab) {
+        out.players.push_back(saved.second);
+    }
+}
+
+size_t GameServer::rollbackBytes(size_t planets, size_t players)
+{
+    return sizeof(RollbackHeader) +
+        planets * (sizeof(RollbackPlanetFixed) + sizeof(RollbackPlanetMotion)) +
+        players * (sizeof(RollbackPlayerFixed) + sizeof(RollbackPlayerMotion));
+}
+
+void GameServer::captureRollback(RollbackStore& store) const
+{
+    auto hasRocket = [](const std::pair<const int, VehicleManager*>& pair) {
+        return pair.second && pair.second->getRocket();
+    };
+    size_t players = static_cast<size_t>(std::count_if(b.begin(), b.end(), hasRocket));
+
+    RollbackHeader header;
+    header.sequenceNumber = e;
+    header.gameTime = f;
+    header.planetCount = static_cast<uint32_t>(a.size());
+    header.playerCount = static_cast<uint32_t>(players);
+    header.stepsHeld = c.hasHeldSteps() ? 1 : 0;
+
+    std::vector<char>& buffer = store.beginCapture();
+    buffer.resize(rollbackBytes(a.size(), players));
+
+    size_t offset = 0;
+    writeRow(buffer, offset, header);
+
+    for (const Planet* planet : a) {
+        RollbackPlanetFixed row = { planet->getMass(), planet->getRadius(), planet->getOwnerId(), planet->getColor().toInteger() };
+        writeRow(buffer, offset, row);
+    }
+    for (const auto& pair : b) {
+        if (!hasRocket(pair)) continue;
+        const Rocket* rocket = pair.second->getRocket();
+        RollbackPlayerFixed row = { pair.first, rocket->getColor().toInteger(), rocket->getMass(), rocket->getStoredMass() };
+        writeRow(buffer, offset, row);
+    }
+    for (size_t index = 0; index < a.size(); index++) {
+        const Planet* planet = a[index];
+        sf::Vector2f acceleration = header.stepsHeld ? c.getHeldAcceleration(index) : sf::Vector2f(0.0f, 0.0f);
+        sf::Vector2f jerk = header.stepsHeld ? c.getHeldJerk(index) : sf::Vector2f(0.0f, 0.0f);
+        RollbackPlanetMotion row = {
+            planet->getPosition().x, planet->getPosition().y, planet->getVelocity().x, planet->getVelocity().y,
+            acceleration.x, acceleration.y, jerk.x, jerk.y
+        };
+        writeRow(buffer, offset, row);
+    }
+    for (const auto& pair : b) {
+        if (!hasRocket(pair)) continue;
+        const Rocket* rocket = pair.second->getRocket();
+        auto sequence = w.find(pair.first);
+        RollbackPlayerMotion row = {
+            rocket->getPosition().x, rocket->getPosition().y,
+            rocket->getVelocity().x, rocket->getVelocity().y,
+            rocket->getRotation(), rocket->getAngularVelocity(), rocket->getThrustLevel(),
+            rocket->getLastStateTimestamp(),
+            sequence != w.end() ? sequence->second : 0u
+        };
+        writeRow(buffer, offset, row);
+    }
+
+    store.commit(e);
+}
+
+bool GameServer::restoreRollback(RollbackStore& store, unsigned long tick)
+{
+    const std::vector<char>* stored = store.load(tick);
+    if (!stored || stored->size() < sizeof(RollbackHeader)) return false;
+    const std::vector<char>& buffer = *stored;
+
+    size_t offset = 0;
+    RollbackHeader header;
+    readRow(buffer, offset, header);
+    if (buffer.size() != rollbackBytes(header.planetCount, header.playerCount)) return false;
+
+    // Merges since the capture deleted planets: rebuild the list. Otherwise
+    // the same Planet objects are overwritten in place
+    bool planetsRebuilt = header.planetCount != a.size();
+    if (planetsRebuilt) {
+        for (Planet* planet : a) {
+            c.removePlanet(planet);
+            delete planet;
+        }
+        a.clear();
+    }
+
+    for (uint32_t index = 0; index < header.planetCount; index++) {
+        RollbackPlanetFixed row;
+        readRow(buffer, offset, row);
+
+        if (planetsRebuilt) {
+            Planet* planet = new Planet(sf::Vector2f(0, 0), row.radius, row.mass, sf::Color(row.color));
+            a.push_back(planet);
+            c.addPlanet(planet);
+        }
+        else if (a[index]->getMass() != row.mass) {
+            a[index]->setMass(row.mass);
+        }
+        a[index]->setOwnerId(row.ownerId);
+    }
+
+    // Players who joined after the capture leave; players who left come back
+    std::vector<WorldPlayerRecord> rockets(header.playerCount);
+    for (WorldPlayerRecord& record : rockets) {
+        RollbackPlayerFixed row;
+        readRow(buffer, offset, row);
+        record.playerId = row.playerId;
+        record.color = row.color;
+        record.mass = row.mass;
+        record.storedMass = row.storedMass;
+    }
+
+    for (uint32_t index = 0; index < header.planetCount; index++) {
+        RollbackPlanetMotion row;
+        readRow(buffer, offset, row);
+        a[index]->setPosition(sf::Vector2f(row.positionX, row.positionY));
+        a[index]->setVelocity(sf::Vector2f(row.velocityX, row.velocityY));
+
+        // The planets' next steps start from what they held at the capture,
+        // or re-simulating could choose other levels than the first time
+        if (header.stepsHeld) {
+            c.holdStep(index, sf::Vector2f(row.accelerationX, row.accelerationY), sf::Vector2f(row.jerkX, row.jerkY));
+        }
+    }
+    if (!header.stepsHeld) {
+        c.dropHeldSteps();
+    }
+
+    std::vector<unsigned int> inputSequences(header.playerCount);
+    for (uint32_t index = 0; index < header.playerCount; index++) {
+        RollbackPlayerMotion row;
+        readRow(buffer, offset, row);
+        WorldPlayerRecord& record = rockets[index];
+        record.positionX = row.positionX;
+        record.positionY = row.positionY;
+        record.velocityX = row.velocityX;
+        record.velocityY = row.velocityY;
+        record.rotation = row.rotation;
+        record.angularVelocity = row.angularVelocity;
+        record.thrustLevel = row.thrustLevel;
+        record.timestamp = row.timestamp;
+        inputSequences[index] = row.lastInputSequence;
+    }
+
+    // Rows were written in player id order, so they can be searched
+    std::vector<int> leaving;
+    for (const auto& pair : b) {
+        auto row = std::lower_bound(rockets.begin(), rockets.end(), pair.first,
+            [](const WorldPlayerRecord& record, int playerId) { return record.playerId < playerId; });
+        if (row == rockets.end() || row->playerId != pair.first) leaving.push_back(pair.first);
+    }
+    for (int playerId : leaving) {
+        removePlayer(playerId);
+    }
+
+    for (uint32_t index = 0; index < header.playerCount; index++) {
+        const WorldPlayerRecord& record = rockets[index];
+        if (b.find(record.playerId) == b.end()) {
+            addPlayer(record.playerId, sf::Vector2f(record.positionX, record.positionY), sf::Color(record.color));
+        }
+
+        VehicleManager* player = getPlayer(record.playerId);
+        if (!player) continue;
+
+        restoreRocket(player, record);
+        if (inputSequences[index] != 0) {
+            w[record.playerId] = inputSequences[index];
+        }
+        else {
+            w.erase(record.playerId);
+        }
+    }
+
+    e = static_cast<unsigned long>(header.sequenceNumber);
+    f = header.gameTime;
+
+    ac.rebuild(a);
+
+    // Ticks recorded after the capture are about to be simulated again
+    k.clear();
+    return true;
+}
+
 void GameServer::update(float deltaTime)
 {
     // Update game time
     f += deltaTime;
 
+    size_t queuedSimulations = l.size();
+
     // Update simulator for server-owned objects
     c.update(deltaTime);
 
-    // Update planets
-    for (auto planet : a) {
-        planet->update(deltaTime);
+    // Merges delete planets inside the simulator; keep our list in step
+    if (c.getPlanetVersion() != ad) {
+        a = c.getPlanets();
+        ad = c.getPlanetVersion();
+    }
+
+    // Update planets, unless the simulator already moved them in its substeps
+    if (!c.getBlockTimesteps()) {
+        for (auto planet : a) {
+            planet->update(deltaTime);
+        }
     }
 
-    // Update players safely
+    // Players find planets through the index, so it must hold this tick's positions
+    ac.rebuild(a);
+
+    // Gravity on every player's rocket in one batch, against the moved planets
+    // as the client predicts it. The batch matches applyGravityToRocket exactly
+    c.applyGravityToVehicles(deltaTime);
+
+    // Players only touch their own vehicles and read the planets, so each one is
+    // an independent job.
+    y.clear();
     for (auto& pair : b) {
         if (pair.second) {
-            pair.second->update(deltaTime);
+            y.push_back(pair.second);
         }
     }
 
+    forEachRange(y.size(), GameConstants::PLAYERS_PER_JOB, [this, deltaTime](size_t first, size_t last) {
+        for (size_t index = first; index < last; index++) {
+            y[index]->update(deltaTime);
+        }
+        });
+
     // Increment sequence number
     e++;
 
+    // Remember this tick so late client states can be compared at their own time
+    recordHistory();
+
+    // Validate all client simulations received since the last tick in one pass
+    validateClientSimulations();
+
     // Periodically synchronize client and server states
     synchronizeState();
+
+    publishMetrics(queuedSimulations);
+}
+
+void GameServer::publishMetrics(size_t queuedSimulations)
+{
+    MetricsContribution now;
+    now.players = static_cast<int64_t>(b.size());
+    now.planets = static_cast<int64_t>(a.size());
+    now.vehicles = static_cast<int64_t>(y.size());
+    now.pendingValidations = static_cast<int64_t>(queuedSimulations);
+    now.pendingCorrections = static_cast<int64_t>(m.size());
+    now.validations = p;
+    now.corrections = q;
+    now.correctionsDeferred = r;
+    ServerMetrics::global().publish(aa, now);
 }
 
 void GameServer::handlePlayerInput(int playerId, const PlayerInput& input)
@@ -120,13 +535,14 @@ void GameServer::handlePlayerInput(int playerId, const PlayerInput& input)
     auto it = b.find(playerId);
     if (it == b.end()) {
         // Player doesn't exist - could be a new connection, create player
-        std::cout << "Unknown player ID: " << playerId << ", creating new player" << std::endl;
+        KLOG_INFO(GAME, "player_created_on_input", "player", playerId);
         sf::Vector2f initialPos = a[0]->getPosition() +
             sf::Vector2f(0, -(a[0]->getRadius() + GameConstants::ROCKET_SIZE));
 
         // Add the player with error handling
-        VehicleManager* player = new VehicleManager(initialPos, a, playerId);
+        VehicleManager* player = new VehicleManager(initialPos, std::vector<Planet*>(), playerId);
         if (player && player->getRocket()) {
+            player->setPlanetIndex(&ac);
             b[playerId] = player;
             c.addVehicleManager(player);
 
@@ -136,7 +552,7 @@ void GameServer::handlePlayerInput(int playerId, const PlayerInput& input)
             i[playerId] = true; // Initially valid
         }
         else {
-            std::cerr << "Failed to create player for ID: " << playerId << std::endl;
+            KLOG_ERROR(GAME, "player_create_failed", "player", playerId);
             delete player;
         }
         return;
@@ -162,50 +578,141 @@ void GameServer::handlePlayerInput(int playerId, const PlayerInput& input)
     if (!player) return; // Add null check
 
     // Apply the input
-    if (input.b) {
-        player->applyThrust(1.0f);
-    }if (input.c) {
-        player->applyThrust(-0.5f);
-    }
-    if (input.d) {
-        player->rotate(-6.0f * input.h * 60.0f);
-    }
-    if (input.e) {
-        player->rotate(6.0f * input.h * 60.0f);
-    }
-    if (input.f) {
-        player->switchVehicle();
-    }
+    player->applyInput(input);
 
-    // Apply thrust level with safe null checking
-    if (player->getActiveVehicleType() == VehicleType::ROCKET && player->getRocket()) {
-        player->getRocket()->setThrustLevel(input.g);
+    // Remember the newest input so the client knows what to stop replaying
+    if (input.l != 0) {
+        auto seqIt = w.find(playerId);
+        if (seqIt == w.end() || static_cast<int>(input.l - seqIt->second) > 0) {
+            w[playerId] = input.l;
+        }
     }
 }
 
 void GameServer::processClientSimulation(int playerId, const GameState& clientState)
 {
-    // Store the client's latest state
+    // Store the client's latest state - only the newest one per tick gets validated
     g[playerId] = clientState;
     h[playerId] = clientState.b; // Update timestamp
 
-    // Validate the client simulation
-    GameState validatedState = validateClientSimulation(playerId, clientState);
+    if (std::find(l.begin(), l.end(), playerId) == l.end()) {
+        l.push_back(playerId);
+    }
+}
 
-    // If validation changed something, send back the corrected state
-    if (!i[playerId]) {
-        // Set the initialState flag to true to force client to accept this state
-        validatedState.e = true;
+void GameServer::setJobSystem(JobSystem* jobs)
+{
+    x = jobs;
+    c.setJobSystem(jobs);
+}
 
-        // TODO: Send validation state back to client
-        // This would be added in NetworkManager with a new message type
+void GameServer::forEachRange(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) const
+{
+    if (x) {
+        x->parallelFor(0, count, grain, body);
+    }
+    else {
+        body(0, count);
     }
 }
 
+void GameServer::validateClientSimulations()
+{
+    // Deferred players are checked again once their rate limit lapses, not every tick until then
+    for (size_t index = 0; index < ae.size();) {
+        int playerId = ae[index];
+        auto lastIt = n.find(playerId);
+        if (lastIt != n.end() && f - lastIt->second < o) {
+            index++;
+            continue;
+        }
+
+        if (std::find(l.begin(), l.end(), playerId) == l.end()) {
+            l.push_back(playerId);
+        }
+        ae.erase(ae.begin() + index);
+    }
+
+    if (l.empty()) return;
+
+    // The comparisons only read server state and history, so they run in parallel;
+    // the bookkeeping below stays on this thread
+    z.assign(l.size(), -1);
+    forEachRange(l.size(), GameConstants::VALIDATIONS_PER_JOB, [this](size_t first, size_t last) {
+        for (size_t index = first; index < last; index++) {
+            int playerId = l[index];
+            auto simIt = g.find(playerId);
+            if (simIt == g.end()) continue; // Player left before the tick ran
+
+            auto playerIt = b.find(playerId);
+            const VehicleManager* player = (playerIt != b.end()) ? playerIt->second : nullptr;
+            if (!player || !player->getRocket()) {
+                z[index] = 0;
+                continue;
+            }
+
+            RocketState serverRocket;
+            z[index] = matchesServerState(player, playerId, simIt->second, serverRocket) ? 1 : 0;
+        }
+        });
+
+    for (size_t index = 0; index < l.size(); index++) {
+        if (z[index] < 0) continue;
+
+        int playerId = l[index];
+        i[playerId] = z[index] > 0;
+        p++;
+
+        if (i[playerId]) continue;
+
+        // Already owed a correction this tick
+        if (std::find(m.begin(), m.end(), playerId) != m.end()) continue;
+
+        // Rate limit corrections per player; retry once the limit lapses. A
+        // newer simulation from a player already waiting isn't another deferral
+        auto lastIt = n.find(playerId);
+        if (lastIt != n.end() && f - lastIt->second < o) {
+            if (std::find(ae.begin(), ae.end(), playerId) == ae.end()) {
+                r++;
+                ae.push_back(playerId);
+            }
+            continue;
+        }
+
+        n[playerId] = f;
+        m.push_back(playerId);
+        q++;
+    }
+
+    l.clear();
+}
+
+void GameServer::takeCorrections(std::vector<int>& out)
+{
+    out.clear();
+    out.swap(m);
+}
+
+void GameServer::logValidationStats(float intervalSeconds)
+{
+    unsigned long validations = p - u;
+    unsigned long corrections = q - v;
+    u = p;
+    v = q;
+
+    float perSecond = intervalSeconds > 0.0f ? corrections / intervalSeconds : 0.0f;
+    float percent = validations > 0 ? 100.0f * corrections / validations : 0.0f;
+
+    std::stringstream ss;
+    ss << "Validation: " << validations << " simulations checked, "
+        << corrections << " corrections sent (" << std::fixed << std::setprecision(2)
+        << perSecond << "/s, " << percent << "%), " << r << " deferred total";
+    s.info(ss.str());
+}
+
 GameState GameServer::validateClientSimulation(int playerId, const GameState& clientState)
 {
     GameState validatedState = clientState;
-    bool isValid = true;
 
     // Get server's state for this player
     VehicleManager* player = getPlayer(playerId);
@@ -214,36 +721,49 @@ GameState GameServer::validateClientSimulation(int playerId, const GameState& cl
         return validatedState;
     }
 
-    // Compare key values between client and server rocket states
-    if (!clientState.c.empty()) {
-        const RocketState& clientRocket = clientState.c[0];
+    RocketState serverRocket;
+    bool isValid = matchesServerState(player, playerId, clientState, serverRocket);
+    if (!isValid) {
+        // Update the client state with server state
+        validatedState.c.clear();
+        validatedState.c.push_back(serverRocket);
+    }
 
-        // Create current server rocket state
-        RocketState serverRocket;
-        player->createState(serverRocket);
+    // Update validation status
+    i[playerId] = isValid;
 
-        // Check position difference
-        sf::Vector2f posDiff = clientRocket.b - serverRocket.b;
-        float posDiffMag = std::sqrt(posDiff.x * posDiff.x + posDiff.y * posDiff.y);
+    return validatedState;
+}
 
-        // Check velocity difference
-        sf::Vector2f velDiff = clientRocket.c - serverRocket.c;
-        float velDiffMag = std::sqrt(velDiff.x * velDiff.x + velDiff.y * velDiff.y);
+bool GameServer::matchesServerState(const VehicleManager* player, int playerId, const GameState& clientState, RocketState& serverRocket) const
+{
+    // Create current server rocket state
+    player->createState(serverRocket);
 
-        // If difference exceeds threshold, client simulation is invalid
-        if (posDiffMag > j || velDiffMag > j * 10.0f) {
-            isValid = false;
+    // Nothing to compare against
+    if (clientState.c.empty()) return true;
 
-            // Update the client state with server state
-            validatedState.c.clear();
-            validatedState.c.push_back(serverRocket);
-        }
+    const RocketState& clientRocket = clientState.c[0];
+
+    // Rewind to the client's timestamp so latency alone doesn't count as divergence
+    sf::Vector2f serverPos = serverRocket.b;
+    sf::Vector2f serverVel = serverRocket.c;
+    HistoryEntry rewound;
+    if (k.sample(playerId, clientState.b, rewound)) {
+        serverPos = rewound.b;
+        serverVel = rewound.c;
     }
 
-    // Update validation status
-    i[playerId] = isValid;
+    // Check position difference
+    sf::Vector2f posDiff = clientRocket.b - serverPos;
+    float posDiffMag = std::sqrt(posDiff.x * posDiff.x + posDiff.y * posDiff.y);
 
-    return validatedState;
+    // Check velocity difference
+    sf::Vector2f velDiff = clientRocket.c - serverVel;
+    float velDiffMag = std::sqrt(velDiff.x * velDiff.x + velDiff.y * velDiff.y);
+
+    // If difference exceeds threshold, client simulation is invalid
+    return !(posDiffMag > j || velDiffMag > j * 10.0f);
 }
 
 void GameServer::synchronizeState()
@@ -275,15 +795,18 @@ void GameServer::synchronizeState()
 
 GameState GameServer::getGameState() const
 {
+    ProfileScope profile(ProfilePhase::GAME_STATE);
+
     GameState state;
     state.a = e;
     state.b = f;
     state.e = false; // Not initial state by default
 
     try {
-        // Add all player rockets
+        // Collect the player rockets first so their states can be filled in parallel
+        std::vector<std::pair<int, const Rocket*>> rockets;
+        rockets.reserve(b.size());
         for (const auto& playerPair : b) {
-            int playerId = playerPair.first;
             const VehicleManager* player = playerPair.second;
 
             // Add null checks
@@ -296,22 +819,35 @@ GameState GameServer::getGameState() const
                 // Add null check for rocket
                 if (!rocket) continue;
 
-                RocketState rocketState;
+                rockets.emplace_back(playerPair.first, rocket);
+            }
+            // TODO: Add car state if needed
+        }
+
+        // Each job writes only its own slots
+        state.c.resize(rockets.size());
+        forEachRange(rockets.size(), GameConstants::SNAPSHOT_ROCKETS_PER_JOB, [this, &rockets, &state](size_t first, size_t last) {
+            for (size_t index = first; index < last; index++) {
+                int playerId = rockets[index].first;
+                const Rocket* rocket = rockets[index].second;
+
+                RocketState& rocketState = state.c[index];
                 rocketState.a = playerId;  // playerId
                 rocketState.b = rocket->getPosition();  // position
                 rocketState.c = rocket->getVelocity();  // velocity
                 rocketState.d = rocket->getRotation();  // rotation
-                rocketState.e = 0.0f;  // angularVelocity - not tracked in current design
+                rocketState.e = rocket->getAngularVelocity();  // angularVelocity
                 rocketState.f = rocket->getThrustLevel();  // thrustLevel
                 rocketState.g = rocket->getMass();  // mass
                 rocketState.h = rocket->getColor();  // color
                 rocketState.i = f;  // current server timestamp
                 rocketState.j = true;  // Server state is authoritative
 
-                state.c.push_back(rocketState);
+                // Newest input already folded into this state
+                auto seqIt = w.find(playerId);
+                rocketState.k = (seqIt != w.end()) ? seqIt->second : 0;
             }
-            // TODO: Add car state if needed
-        }
+            });
 
         // Add all planets
         for (size_t i = 0; i < a.size(); ++i) {
@@ -332,9 +868,16 @@ GameState GameServer::getGameState() const
 
             state.d.push_back(planetState);
         }
+
+        // Rockets come out in player id order and planets in simulator order, and
+        // every simulated field is derived from the fixed tick and the inputs
+        // alone, so the hash is the same on every machine stepping the same inputs
+        if (t.isDeterministic()) {
+            state.f = hashStateBodies(state);
+        }
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in getGameState: " << ex.what() << std::endl;
+        KLOG_ERROR(GAME, "exception", "where", "getGameState", "error", ex.what());
         // Return a minimal valid state to avoid crashes
     }
 
@@ -350,37 +893,52 @@ int GameServer::addPlayer(int playerId, sf::Vector2f initialPos, sf::Color color
 
     try {
         // Create a new vehicle manager for this player
-        VehicleManager* player = new VehicleManager(initialPos, a, playerId);
+        VehicleManager* player = new VehicleManager(initialPos, std::vector<Planet*>(), playerId);
 
         // Make sure rocket was initialized properly
         if (player && player->getRocket()) {
+            // It finds planets through the shared index
+            player->setPlanetIndex(&ac);
             player->getRocket()->setColor(color);
 
-            // Add to simulator
+            // Store in players map; the simulator pulls its rocket with everyone else's
+            b[playerId] = player;
             c.addVehicleManager(player);
 
-            // Store in players map
-            b[playerId] = player;
+            // A player saved in a restored world gets its rocket back
+            auto saved = ab.find(playerId);
+            if (saved != ab.end()) {
+                restoreRocket(player, saved->second);
+                ab.erase(saved);
+            }
 
             // Initialize client simulation tracking
             g[playerId] = GameState();
             h[playerId] = f; // Current game time
             i[playerId] = true; // Initially valid
 
-            std::cout << "Added player with ID: " << playerId << std::endl;
+            KLOG_INFO(GAME, "player_added", "player", playerId, "position", initialPos);
         }
         else {
-            std::cerr << "Failed to initialize rocket for player ID: " << playerId << std::endl;
+            KLOG_ERROR(GAME, "player_create_failed", "player", playerId);
             delete player; // Clean up if rocket initialization failed
         }
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception when adding player ID " << playerId << ": " << ex.what() << std::endl;
+        KLOG_ERROR(GAME, "exception", "where", "addPlayer", "player", playerId, "error", ex.what());
     }
 
     return playerId;
 }
 
+sf::Vector2f GameServer::getClientSpawnPosition() const
+{
+    if (a.empty() || !a[0]) return sf::Vector2f(400.f, 100.f);
+
+    return a[0]->getPosition() +
+        sf::Vector2f(0, -(a[0]->getRadius() + GameConstants::ROCKET_SIZE + 30.0f));
+}
+
 void GameServer::removePlayer(int playerId)
 {
     auto playerIt = b.find(playerId);
@@ -399,7 +957,17 @@ void GameServer::removePlayer(int playerId)
         h.erase(playerId);
         i.erase(playerId);
 
-        std::cout << "Removed player " << playerId << std::endl;
+        // IDs get reused, so don't let a new player rewind into this one's history
+        k.forget(playerId);
+
+        // Drop any queued validation or correction
+        l.erase(std::remove(l.begin(), l.end(), playerId), l.end());
+        m.erase(std::remove(m.begin(), m.end(), playerId), m.end());
+        ae.erase(std::remove(ae.begin(), ae.end(), playerId), ae.end());
+        n.erase(playerId);
+        w.erase(playerId);
+
+        KLOG_INFO(GAME, "player_removed", "player", playerId);
     }
 }
 
@@ -438,15 +1006,15 @@ void GameServer::createSolarSystem()
         float angle = (i * 40.0f) * (3.14159f / 180.0f); // Distribute planets around the sun
 
         // Calculate position based on orbit distance and angle
-        float planetX = mainPlanet->getPosition().x + orbitDistance * cos(angle);
-        float planetY = mainPlanet->getPosition().y + orbitDistance * sin(angle);
+        float planetX = mainPlanet->getPosition().x + orbitDistance * DeterministicMath::cosine(angle);
+        float planetY = mainPlanet->getPosition().y + orbitDistance * DeterministicMath::sine(angle);
 
         // Calculate orbital velocity for a circular orbit
         float orbitalVelocity = std::sqrt(GameConstants::G * mainPlanet->getMass() / orbitDistance);
 
         // Velocity is perpendicular to position vector
-        float velocityX = -sin(angle) * orbitalVelocity;
-        float velocityY = cos(angle) * orbitalVelocity;
+        float velocityX = -DeterministicMath::sine(angle) * orbitalVelocity;
+        float velocityY = DeterministicMath::cosine(angle) * orbitalVelocity;
 
         // Create the planet with scaled mass
         Planet* planet = new Planet(
@@ -459,6 +1027,21 @@ void GameServer::createSolarSystem()
     }
 }
 
+void GameServer::recordHistory()
+{
+    k.beginTick(e, f);
+
+    for (const auto& playerPair : b) {
+        const VehicleManager* player = playerPair.second;
+        if (!player || player->getActiveVehicleType() != VehicleType::ROCKET) continue;
+
+        const Rocket* rocket = player->getRocket();
+        if (!rocket) continue;
+
+        k.record(playerPair.first, rocket->getPosition(), rocket->getVelocity(), rocket->getRotation());
+    }
+}
+
 // Add handlePlayerDisconnect implementation
 void GameServer::handlePlayerDisconnect(int clientId) {
     // Remove the player from the game
@@ -10,6 +10,12 @@
 #include <SFML/Graphics.hpp>
 #include "ServerLogger.h"
 #include "ServerConfig.h"
+#include "StateHistory.h"
+#include "JobSystem.h"
+#include "ServerMetrics.h"
+#include "WorldFile.h"
+#include "RollbackStore.h"
+#include "PlanetIndex.h"
 
 class GameServer {
 private:
@@ -30,12 +36,53 @@ private:
     std::map<int, float> h; // lastClientUpdateTime - when each client last sent their simulation
     std::map<int, bool> i; // clientSimulationValid - whether each client's simulation is valid
     float j; // validationThreshold - how much difference is allowed before correcting client
+    StateHistory k; // stateHistory - recent ticks used to rewind to a client's timestamp
+
+    // Batched validation and correction delivery
+    std::vector<int> l; // pendingSimulations - players whose latest simulation awaits validation this tick
+    std::vector<int> m; // pendingCorrections - players owed a correction in the next snapshot
+    std::map<int, float> n; // lastCorrectionTime - game time each player was last corrected
+    float o; // correctionInterval - minimum game time between corrections to one player
+    unsigned long p; // validationsRun
+    unsigned long q; // correctionsSent
+    unsigned long r; // correctionsDeferred - held back by the rate limit
+    unsigned long u; // validationsAtLastReport
+    unsigned long v; // correctionsAtLastReport
+    std::map<int, unsigned int> w; // lastInputSequence - newest input applied per player, echoed in snapshots
+
+    // Parallel tick work
+    JobSystem* x; // jobs - optional worker pool for the per-tick loops (nullptr runs them serially)
+    std::vector<VehicleManager*> y; // playerList - players flattened for the parallel loops
+    std::vector<signed char> z; // validationResults - per pending simulation: 1 valid, 0 invalid, -1 player gone
+
+    MetricsContribution aa; // publishedMetrics - what this server last added to ServerMetrics::global()
+    std::map<int, WorldPlayerRecord> ab; // restoredPlayers - saved rockets from a warm start, handed back when their player joins
+    PlanetIndex ac; // planetIndex - spatial hash of the planets, rebuilt each tick after they move; players query it
+    unsigned long ad; // planetVersion - simulator planet version a was last copied at
+    std::vector<int> ae; // deferredSimulations - invalid simulations held back by the rate limit until it lapses
 
 public:
     GameServer(ServerLogger& logger, ServerConfig& config);
     ~GameServer();
 
     void initialize();
+
+    // Warm start: rebuild the world saved in a world file instead of the default
+    // solar system. Returns false, changing nothing, if the file has no planets
+    bool restoreWorld(const MappedWorld& world);
+
+    // Copy the bodies, players and counters into a flat snapshot for a world file
+    void captureWorld(WorldSnapshot& out) const;
+
+    // Capture the simulation - bodies, rockets, applied inputs and counters -
+    // into a rollback store under the current sequence number, and roll back
+    // to a captured tick. Car state and client validation bookkeeping aren't
+    // captured, and the rewind history is cleared on restore
+    void captureRollback(RollbackStore& store) const;
+    bool restoreRollback(RollbackStore& store, unsigned long tick);
+
+    // Bytes captureRollback writes for a world of this size, for sizing a store
+    static size_t rollbackBytes(size_t planets, size_t players);
     void update(float deltaTime);
 
     // Handle input from clients
@@ -44,24 +91,38 @@ public:
     // Add missing handlePlayerDisconnect method
     void handlePlayerDisconnect(int clientId);
 
-    // New method to process client simulation states
+    // Queue a client simulation state for validation on the next tick
     void processClientSimulation(int playerId, const GameState& clientState);
 
+    // Hand over the players that should receive a correction with the next snapshot
+    void takeCorrections(std::vector<int>& out);
+
+    // Log validation counters and the correction rate since the last report
+    void logValidationStats(float intervalSeconds);
+
     // Validate client simulation against server state
     GameState validateClientSimulation(int playerId, const GameState& clientState);
 
     // Get the current game state to send to clients
     GameState getGameState() const;
 
+    // Spread player updates, validation and snapshot building over a job system
+    void setJobSystem(JobSystem* jobs);
+
     // Add/remove players
     int addPlayer(int playerId, sf::Vector2f initialPos = sf::Vector2f(0, 0), sf::Color color = sf::Color::White);
     void removePlayer(int playerId);
 
+    // Where a newly connected client's rocket starts: just above the main planet
+    sf::Vector2f getClientSpawnPosition() const;
+
     // Synchronize states between server and clients
     void synchronizeState();
 
     // Getters
+    unsigned long getSequenceNumber() const { return e; }
     const std::vector<Planet*>& getPlanets() const { return a; }
+    const PlanetIndex& getPlanetIndex() const { return ac; }
     const std::map<int, VehicleManager*>& getPlayers() const { return b; }
     VehicleManager* getPlayer(int playerId) {
         auto it = b.find(playerId);
@@ -72,7 +133,33 @@ public:
     void setValidationThreshold(float threshold) { j = threshold; }
     float getValidationThreshold() const { return j; }
 
+    // Correction rate limiting and counters
+    void setCorrectionInterval(float interval) { o = interval; }
+    float getCorrectionInterval() const { return o; }
+    unsigned long getValidationsRun() const { return p; }
+    unsigned long getCorrectionsSent() const { return q; }
+    unsigned long getCorrectionsDeferred() const { return r; }
+
 private:
     // Create the initial solar system
     void createSolarSystem();
+
+    // Put the host player in the world, at rest on the main planet
+    void addHostPlayer();
+
+    // Store the current player states in the history ring
+    void recordHistory();
+
+    // Validate every simulation queued since the last tick
+    void validateClientSimulations();
+
+    // Compare a client's rocket with the server's at the client's timestamp. Only reads
+    // server state, so it can run on any thread; fills serverRocket with the current state
+    bool matchesServerState(const VehicleManager* player, int playerId, const GameState& clientState, RocketState& serverRocket) const;
+
+    // Publish this tick's player, body and queue counts to the process-wide metrics
+    void publishMetrics(size_t queuedSimulations);
+
+    // Run body over [0, count) on the job system if there is one, otherwise inline
+    void forEachRange(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) const;
 };
\ No newline at end of file
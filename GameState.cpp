@@ -1,5 +1,30 @@
 // GameState.cpp
 #include "GameState.h"
+#include <cstring>
+
+namespace {
+    // FNV-1a, fed four bytes at a time in a fixed byte order
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashWord(uint64_t& hash, uint32_t word) {
+        for (int i = 0; i < 4; i++) {
+            hash ^= (word >> (i * 8)) & 0xFF;
+            hash *= FNV_PRIME;
+        }
+    }
+
+    void hashFloat(uint64_t& hash, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hashWord(hash, bits);
+    }
+
+    void hashVector(uint64_t& hash, const sf::Vector2f& value) {
+        hashFloat(hash, value.x);
+        hashFloat(hash, value.y);
+    }
+}
 
 // Implement serialization for sf::Vector2f
 sf::Packet& operator<<(sf::Packet& packet, const sf::Vector2f& vector) {
@@ -23,13 +48,18 @@ sf::Packet& operator>>(sf::Packet& packet, sf::Color& color) {
 sf::Packet& operator<<(sf::Packet& packet, const RocketState& state) {
     return packet << state.a << state.b << state.c
         << state.d << state.e << state.f
-        << state.g << state.h << state.i << state.j;
+        << state.g << state.h << state.i << state.j
+        << static_cast<uint32_t>(state.k);
 }
 
 sf::Packet& operator>>(sf::Packet& packet, RocketState& state) {
-    return packet >> state.a >> state.b >> state.c
+    uint32_t inputSeq = 0;
+    packet >> state.a >> state.b >> state.c
         >> state.d >> state.e >> state.f
-        >> state.g >> state.h >> state.i >> state.j;
+        >> state.g >> state.h >> state.i >> state.j
+        >> inputSeq;
+    state.k = inputSeq;
+    return packet;
 }
 
 // Implement PlanetState serialization
@@ -45,7 +75,7 @@ sf::Packet& operator>>(sf::Packet& packet, PlanetState& state) {
 
 // Implement GameState serialization
 sf::Packet& operator<<(sf::Packet& packet, const GameState& state) {
-    packet << static_cast<uint32_t>(state.a) << state.b << state.e;
+    packet << static_cast<uint32_t>(state.a) << state.b << state.e << state.f;
 
     // Serialize rockets
     packet << static_cast<uint32_t>(state.c.size());
@@ -64,7 +94,7 @@ sf::Packet& operator<<(sf::Packet& packet, const GameState& state) {
 
 sf::Packet& operator>>(sf::Packet& packet, GameState& state) {
     uint32_t seqNum;
-    packet >> seqNum >> state.b >> state.e;
+    packet >> seqNum >> state.b >> state.e >> state.f;
     state.a = seqNum;
 
     // Deserialize rockets
@@ -84,4 +114,33 @@ sf::Packet& operator>>(sf::Packet& packet, GameState& state) {
     }
 
     return packet;
+}
+
+uint64_t hashStateBodies(const GameState& state) {
+    uint64_t hash = FNV_OFFSET;
+    hashWord(hash, static_cast<uint32_t>(state.a));
+    hashFloat(hash, state.b);
+
+    hashWord(hash, static_cast<uint32_t>(state.c.size()));
+    for (const RocketState& rocket : state.c) {
+        hashWord(hash, static_cast<uint32_t>(rocket.a));
+        hashVector(hash, rocket.b);
+        hashVector(hash, rocket.c);
+        hashFloat(hash, rocket.d);
+        hashFloat(hash, rocket.e);
+        hashFloat(hash, rocket.f);
+        hashFloat(hash, rocket.g);
+        hashWord(hash, rocket.k);
+    }
+
+    hashWord(hash, static_cast<uint32_t>(state.d.size()));
+    for (const PlanetState& planet : state.d) {
+        hashWord(hash, static_cast<uint32_t>(planet.a));
+        hashVector(hash, planet.b);
+        hashVector(hash, planet.c);
+        hashFloat(hash, planet.d);
+        hashFloat(hash, planet.e);
+        hashWord(hash, static_cast<uint32_t>(planet.g));
+    }
+    return hash;
 }
\ No newline at end of file
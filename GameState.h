@@ -4,6 +4,7 @@
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Color.hpp>
 #include <vector>
+#include <cstdint>
 #include <SFML/Graphics.hpp>
 // Forward declarations for packet operators
 struct RocketState;
@@ -30,6 +31,7 @@ struct RocketState {
     sf::Color h; // color
     float i; // timestamp of this state
     bool j; // isAuthoritative - whether this is definitive state from server
+    unsigned int k = 0; // lastInputSequence - newest input from this player the server has applied
 
     // Packet operators for serialization
     friend sf::Packet& operator <<(sf::Packet& packet, const RocketState& state);
@@ -59,8 +61,15 @@ struct GameState {
     std::vector<RocketState> c; // rockets
     std::vector<PlanetState> d; // planets
     bool e; // isInitialState - if this is the first state sent to client
+    uint64_t f = 0; // stateHash - hashStateBodies of this state in deterministic mode, 0 otherwise
 
     // Packet operators for serialization
     friend sf::Packet& operator <<(sf::Packet& packet, const GameState& state);
     friend sf::Packet& operator >>(sf::Packet& packet, GameState& state);
-};
\ No newline at end of file
+};
+
+// Hash of the simulated fields of every body, in snapshot order, over their
+// exact bit patterns. Two simulations that agree to the bit hash the same, so a
+// client stepping the same inputs can compare one number instead of the whole
+// state. Colors and the hash field itself are left out.
+uint64_t hashStateBodies(const GameState& state);
\ No newline at end of file
@@ -2,12 +2,40 @@
 #include "GravitySimulator.h"
 #include "VehicleManager.h"
 #include "VectorHelper.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "TickProfiler.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+
+// The batched rocket pass runs four rockets per SSE instruction where the
+// target has it. SSE float math is IEEE single precision like the scalar
+// path, so both round identically
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define GRAVITY_BATCH_SSE 1
+#endif
+
+namespace {
+    // One planet's pull on one rocket. The batched pass does the same
+    // operations in the same order, so every path agrees to the bit
+    inline void pullToward(float planetX, float planetY, float planetMass, float planetReach,
+        float x, float y, float mass, float G, float deltaTime, float& velocityX, float& velocityY) {
+        float dx = planetX - x;
+        float dy = planetY - y;
+        float dist = std::sqrt(dx * dx + dy * dy);
+
+        // Avoid division by zero and very small distances
+        if (dist > planetReach) {
+            float force = G * planetMass * mass / (dist * dist);
+            velocityX = velocityX + dx / dist * force / mass * deltaTime;
+            velocityY = velocityY + dy / dist * force / mass * deltaTime;
+        }
+    }
+}
 
 GravitySimulator::GravitySimulator(int ownerId)
-    : d(GameConstants::G), e(true), f(ownerId)
+    : d(GameConstants::G), e(true), f(ownerId), g(nullptr), h(1), j(true), l(false), o(1)
 {
     // Constructor implementation
 }
@@ -16,6 +44,7 @@ void GravitySimulator::addPlanet(Planet* planet)
 {
     if (planet) {
         a.push_back(planet);
+        h++;
     }
 }
 
@@ -24,6 +53,7 @@ void GravitySimulator::removePlanet(Planet* planet)
     auto it = std::find(a.begin(), a.end(), planet);
     if (it != a.end()) {
         a.erase(it);
+        h++;
     }
 }
 
@@ -59,110 +89,418 @@ bool GravitySimulator::shouldSimulateObject(int objectOwnerId) const
     return objectOwnerId == f;
 }
 
-void GravitySimulator::updateVehicleManagerPlanets() {
-    if (!c) return;
+void GravitySimulator::addVehicleManager(VehicleManager* manager)
+{
+    if (!manager || std::find(c.begin(), c.end(), manager) != c.end()) return;
 
+    c.push_back(manager);
     try {
-        c->updatePlanets(a);
+        manager->updatePlanets(a, h);
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in updateVehicleManagerPlanets: " << ex.what() << std::endl;
+        KLOG_ERROR(PHYSICS, "exception", "where", "addVehicleManager", "error", ex.what());
+    }
+}
+
+void GravitySimulator::removeVehicleManager(VehicleManager* manager)
+{
+    auto it = std::find(c.begin(), c.end(), manager);
+    if (it != c.end()) {
+        c.erase(it);
+    }
+}
+
+void GravitySimulator::updateVehicleManagerPlanets() {
+    for (VehicleManager* manager : c) {
+        try {
+            manager->updatePlanets(a, h);
+        }
+        catch (const std::exception& ex) {
+            KLOG_ERROR(PHYSICS, "exception", "where", "updateVehicleManagerPlanets", "owner", manager->getOwnerId(), "error", ex.what());
+        }
     }
 }
 
 void GravitySimulator::update(float deltaTime)
 {
+    ProfileScope profile(ProfilePhase::GRAVITY);
+
     // Apply gravity between planets if enabled
-    if (e) {
-        for (size_t i = 0; i < a.size(); i++) {
-            // Only process planets we should simulate
-            if (!shouldSimulateObject(a[i]->getOwnerId())) continue;
-
-            for (size_t j = i + 1; j < a.size(); j++) {
-                // Only process planets we should simulate
-                if (!shouldSimulateObject(a[j]->getOwnerId())) continue;
-
-                // Skip the first planet (index 0) - it's pinned in place
-                if (i == 0) {
-                    // Only apply gravity from planet1 to planet2
-                    sf::Vector2f dir = a[i]->getPosition() - a[j]->getPosition();
-                    float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-
-                    if (dist > a[i]->getRadius() + a[j]->getRadius()) {
-                        float force = d * a[i]->getMass() * a[j]->getMass() / (dist * dist);
-                        sf::Vector2f normDir = normalize(dir);
-                        sf::Vector2f accel = normDir * force / a[j]->getMass();
-                        a[j]->setVelocity(a[j]->getVelocity() + accel * deltaTime);
-                    }
-                }
-                else {
-                    // Regular gravity calculation between other planets
-                    sf::Vector2f dir = a[j]->getPosition() - a[i]->getPosition();
-                    float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-
-                    if (dist > a[i]->getRadius() + a[j]->getRadius()) {
-                        float force = d * a[i]->getMass() * a[j]->getMass() / (dist * dist);
-                        sf::Vector2f normDir = normalize(dir);
-                        sf::Vector2f accel1 = normDir * force / a[i]->getMass();
-                        sf::Vector2f accel2 = -normDir * force / a[j]->getMass();
-                        a[i]->setVelocity(a[i]->getVelocity() + accel1 * deltaTime);
-                        a[j]->setVelocity(a[j]->getVelocity() + accel2 * deltaTime);
-                    }
+    if (l) {
+        stepPlanetsInBlocks(deltaTime);
+    }
+    else if (e) {
+        applyGravityBetweenPlanets(deltaTime);
+    }
+
+    // Apply gravity to every registered player's active rocket
+    if (j) {
+        applyGravityToVehicles(deltaTime);
+    }
+
+    // Legacy code for handling individual rockets
+    for (auto rocket : b) {
+        // Only process rockets we should simulate
+        if (!shouldSimulateObject(rocket->getOwnerId())) continue;
+
+        applyGravityToRocket(rocket, deltaTime);
+    }
+
+    // Add rocket-to-rocket gravity interactions between the individual rockets
+    addRocketGravityInteractions(deltaTime);
+
+    // Check for planet collisions and cleanup
+    checkPlanetCollisions();
+}
+
+void GravitySimulator::applyGravityBetweenPlanets(float deltaTime)
+{
+    // Each planet sums the pull of every other planet and only writes its own
+    // velocity, so planets can be split across jobs. Positions are read-only here.
+    auto accelerate = [this, deltaTime](size_t first, size_t last) {
+        for (size_t k = first; k < last; k++) {
+            // The first planet (index 0) is pinned in place
+            if (k == 0) continue;
+
+            Planet* planet = a[k];
+            if (!shouldSimulateObject(planet->getOwnerId())) continue;
+
+            sf::Vector2f velocity = planet->getVelocity();
+            for (size_t m = 0; m < a.size(); m++) {
+                if (m == k) continue;
+
+                const Planet* other = a[m];
+                if (!shouldSimulateObject(other->getOwnerId())) continue;
+
+                sf::Vector2f dir = other->getPosition() - planet->getPosition();
+                float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+
+                if (dist > other->getRadius() + planet->getRadius()) {
+                    float force = d * other->getMass() * planet->getMass() / (dist * dist);
+                    sf::Vector2f accel = normalize(dir) * force / planet->getMass();
+                    velocity += accel * deltaTime;
                 }
             }
+            planet->setVelocity(velocity);
         }
+        };
+
+    if (g) {
+        g->parallelFor(0, a.size(), GameConstants::PLANETS_PER_JOB, accelerate);
     }
+    else {
+        accelerate(0, a.size());
+    }
+}
 
-    // Apply gravity to the vehicle manager's active vehicle
-    if (c) {
-        // Only apply if we should simulate this vehicle
-        if (shouldSimulateObject(c->getOwnerId())) {
-            if (c->getActiveVehicleType() == VehicleType::ROCKET) {
-                Rocket* rocket = c->getRocket();
-                if (rocket) {
-                    for (auto planet : a) {
-                        sf::Vector2f dir = planet->getPosition() - rocket->getPosition();
-                        float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-
-                        // Avoid division by zero and very small distances
-                        if (dist > planet->getRadius() + GameConstants::TRAJECTORY_COLLISION_RADIUS) {
-                            float force = d * planet->getMass() * rocket->getMass() / (dist * dist);
-                            sf::Vector2f accel = normalize(dir) * force / rocket->getMass();
-                            sf::Vector2f velChange = accel * deltaTime;
-                            rocket->setVelocity(rocket->getVelocity() + velChange);
-                        }
-                    }
-                }
+sf::Vector2f GravitySimulator::planetAcceleration(size_t index, sf::Vector2f* jerk) const
+{
+    const Planet* planet = a[index];
+    sf::Vector2f acceleration(0.0f, 0.0f);
+
+    for (size_t otherIndex = 0; otherIndex < a.size(); otherIndex++) {
+        if (otherIndex == index) continue;
+
+        const Planet* other = a[otherIndex];
+        if (!shouldSimulateObject(other->getOwnerId())) continue;
+
+        sf::Vector2f dir = other->getPosition() - planet->getPosition();
+        float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+        if (dist <= other->getRadius() + planet->getRadius()) continue;
+
+        // Same pull as applyGravityBetweenPlanets. Scale by one scalar divide:
+        // dir / dist compiles to a packed divide whose unused lanes can stall
+        float pull = d * other->getMass() / (dist * dist);
+        acceleration += dir * (pull / dist);
+
+        if (jerk) {
+            // How fast that pull changes as the two move: G*m * (v/r^3 - 3(r.v)r/r^5)
+            sf::Vector2f relative = other->getVelocity() - planet->getVelocity();
+            float radial = (dir.x * relative.x + dir.y * relative.y) / (dist * dist);
+            *jerk += (relative - dir * (3.0f * radial)) * (pull / dist);
+        }
+    }
+    return acceleration;
+}
+
+bool GravitySimulator::hasHeldSteps() const
+{
+    if (r.size() != a.size()) return false;
+
+    for (size_t index = 0; index < a.size(); index++) {
+        const HeldPlanet& held = r[index];
+        const Planet* planet = a[index];
+        if (held.planet != planet || held.position != planet->getPosition() || held.velocity != planet->getVelocity() ||
+            held.mass != planet->getMass() || held.radius != planet->getRadius() || held.ownerId != planet->getOwnerId()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GravitySimulator::holdStep(size_t index, sf::Vector2f acceleration, sf::Vector2f jerk)
+{
+    p.resize(a.size());
+    q.resize(a.size());
+    r.resize(a.size());
+
+    p[index] = acceleration;
+    q[index] = jerk;
+    holdPlanet(index);
+}
+
+void GravitySimulator::holdPlanet(size_t index)
+{
+    const Planet* planet = a[index];
+    r[index] = { planet, planet->getPosition(), planet->getVelocity(), planet->getMass(), planet->getRadius(), planet->getOwnerId() };
+}
+
+void GravitySimulator::stepPlanetsInBlocks(float deltaTime)
+{
+    const size_t count = a.size();
+    m.assign(count, -1);
+    o = 1;
+
+    if (!e) {
+        for (Planet* planet : a) {
+            planet->update(deltaTime);
+        }
+        return;
+    }
+
+    // What the last update ended with is reused while nothing has touched
+    // the planets since. A merge, a snapshot from the server or a restore
+    // costs a fresh pull pass instead
+    const bool held = hasHeldSteps();
+    p.resize(count);
+    q.resize(count);
+
+    // Levels come from the state at the start of the update. A planet whose
+    // pull changes quickly for its size (a close pass, deep in a well) halves
+    // its step until it's under ETA * |acceleration| / |jerk|
+    auto chooseLevels = [this, deltaTime, held](size_t first, size_t last) {
+        for (size_t index = first; index < last; index++) {
+            // The first planet (index 0) is pinned in place
+            if (index == 0 || !shouldSimulateObject(a[index]->getOwnerId())) continue;
+
+            if (!held) {
+                q[index] = sf::Vector2f(0.0f, 0.0f);
+                p[index] = planetAcceleration(index, &q[index]);
+            }
+            sf::Vector2f acceleration = p[index];
+            sf::Vector2f jerk = q[index];
+            float accelerationSize = std::sqrt(acceleration.x * acceleration.x + acceleration.y * acceleration.y);
+            float jerkSize = std::sqrt(jerk.x * jerk.x + jerk.y * jerk.y);
+
+            int level = 0;
+            float step = deltaTime;
+            while (level < GameConstants::MAX_BLOCK_TIMESTEP_LEVEL &&
+                step * jerkSize > GameConstants::BLOCK_TIMESTEP_ETA * accelerationSize) {
+                step *= 0.5f;
+                level++;
             }
-            // Car gravity is handled internally in Car::update
+            m[index] = level;
         }
+        };
+
+    if (g && !held) {
+        g->parallelFor(0, count, GameConstants::PLANETS_PER_JOB, chooseLevels);
     }
     else {
-        // Legacy code for handling individual rockets
-        for (auto rocket : b) {
-            // Only process rockets we should simulate
-            if (!shouldSimulateObject(rocket->getOwnerId())) continue;
+        chooseLevels(0, count);
+    }
 
-            for (auto planet : a) {
-                sf::Vector2f dir = planet->getPosition() - rocket->getPosition();
-                float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+    int deepest = count > 0 ? *std::max_element(m.begin(), m.end()) : 0;
+    o = 1u << std::max(0, deepest);
+
+    // Walk the finest substeps with kick-drift-kick leapfrog per planet: half
+    // a kick when its step starts, everyone drifts every substep, and the
+    // other half from the new positions when its step ends. Velocities are
+    // then in step with positions at every step boundary, which keeps
+    // switching levels between updates from costing accuracy. Every planet's
+    // step ends with the last substep, so the update ends in sync
+    const float substep = deltaTime / static_cast<float>(o);
+    for (unsigned int s = 0; s < o; s++) {
+        for (size_t index = 0; index < count; index++) {
+            int level = m[index];
+            if (level >= 0 && s % (o >> level) == 0) {
+                float halfStep = 0.5f * deltaTime / static_cast<float>(1u << level);
+                a[index]->setVelocity(a[index]->getVelocity() + p[index] * halfStep);
+            }
+        }
+
+        for (Planet* planet : a) {
+            planet->update(substep);
+        }
 
-                // Avoid division by zero and very small distances
-                if (dist > planet->getRadius() + GameConstants::TRAJECTORY_COLLISION_RADIUS) {
-                    float force = d * planet->getMass() * rocket->getMass() / (dist * dist);
-                    sf::Vector2f accel = normalize(dir) * force / rocket->getMass();
-                    sf::Vector2f velChange = accel * deltaTime;
-                    rocket->setVelocity(rocket->getVelocity() + velChange);
+        n.clear();
+        for (size_t index = 0; index < count; index++) {
+            int level = m[index];
+            if (level >= 0 && (s + 1) % (o >> level) == 0) {
+                n.push_back(index);
+            }
+        }
+
+        // Accelerations only read positions and each kick writes its own
+        // velocity; the acceleration is kept for the next step's first half.
+        // The last substep also takes the jerk for the next update's levels.
+        // That reads velocities, so its kicks wait until every planet is done
+        const bool finalSubstep = s + 1 == o;
+        auto closeStep = [this, deltaTime, finalSubstep](size_t first, size_t last) {
+            for (size_t active = first; active < last; active++) {
+                size_t index = n[active];
+                if (finalSubstep) {
+                    q[index] = sf::Vector2f(0.0f, 0.0f);
+                    p[index] = planetAcceleration(index, &q[index]);
+                    continue;
                 }
+                p[index] = planetAcceleration(index, nullptr);
+                float halfStep = 0.5f * deltaTime / static_cast<float>(1u << m[index]);
+                a[index]->setVelocity(a[index]->getVelocity() + p[index] * halfStep);
             }
+            };
+
+        if (g && n.size() > GameConstants::PLANETS_PER_JOB) {
+            g->parallelFor(0, n.size(), GameConstants::PLANETS_PER_JOB, closeStep);
+        }
+        else {
+            closeStep(0, n.size());
         }
 
-        // Add rocket-to-rocket gravity interactions
-        addRocketGravityInteractions(deltaTime);
+        if (finalSubstep) {
+            for (size_t index : n) {
+                float halfStep = 0.5f * deltaTime / static_cast<float>(1u << m[index]);
+                a[index]->setVelocity(a[index]->getVelocity() + p[index] * halfStep);
+            }
+        }
     }
 
-    // Check for planet collisions and cleanup
-    checkPlanetCollisions();
+    r.resize(count);
+    for (size_t index = 0; index < count; index++) {
+        holdPlanet(index);
+    }
+}
+
+void GravitySimulator::applyGravityToRocket(Rocket* rocket, float deltaTime) const
+{
+    if (!rocket) return;
+
+    sf::Vector2f position = rocket->getPosition();
+    sf::Vector2f velocity = rocket->getVelocity();
+    float mass = rocket->getMass();
+
+    for (auto planet : a) {
+        if (!planet) continue;
+
+        sf::Vector2f planetPosition = planet->getPosition();
+        pullToward(planetPosition.x, planetPosition.y, planet->getMass(),
+            planet->getRadius() + GameConstants::TRAJECTORY_COLLISION_RADIUS,
+            position.x, position.y, mass, d, deltaTime, velocity.x, velocity.y);
+    }
+    rocket->setVelocity(velocity);
+}
+
+void GravitySimulator::applyGravityToVehicles(float deltaTime)
+{
+    // Gather the rockets to pull into the batch arrays
+    k.rockets.clear();
+    k.positionX.clear();
+    k.positionY.clear();
+    k.velocityX.clear();
+    k.velocityY.clear();
+    k.mass.clear();
+    for (VehicleManager* manager : c) {
+        // Car gravity is handled internally in Car::update
+        if (!shouldSimulateObject(manager->getOwnerId())) continue;
+        if (manager->getActiveVehicleType() != VehicleType::ROCKET) continue;
+
+        Rocket* rocket = manager->getRocket();
+        if (!rocket) continue;
+
+        k.rockets.push_back(rocket);
+        k.positionX.push_back(rocket->getPosition().x);
+        k.positionY.push_back(rocket->getPosition().y);
+        k.velocityX.push_back(rocket->getVelocity().x);
+        k.velocityY.push_back(rocket->getVelocity().y);
+        k.mass.push_back(rocket->getMass());
+    }
+    if (k.rockets.empty()) return;
+
+    k.planetX.clear();
+    k.planetY.clear();
+    k.planetMass.clear();
+    k.planetReach.clear();
+    for (const Planet* planet : a) {
+        if (!planet) continue;
+
+        k.planetX.push_back(planet->getPosition().x);
+        k.planetY.push_back(planet->getPosition().y);
+        k.planetMass.push_back(planet->getMass());
+        k.planetReach.push_back(planet->getRadius() + GameConstants::TRAJECTORY_COLLISION_RADIUS);
+    }
+
+    // Rockets only write their own lanes, so ranges of them can run as jobs
+    size_t count = k.rockets.size();
+    if (g && count > GameConstants::GRAVITY_ROCKETS_PER_JOB) {
+        g->parallelFor(0, count, GameConstants::GRAVITY_ROCKETS_PER_JOB, [this, deltaTime](size_t first, size_t last) {
+            applyGravityToRocketRange(first, last, deltaTime);
+            });
+    }
+    else {
+        applyGravityToRocketRange(0, count, deltaTime);
+    }
+
+    for (size_t index = 0; index < count; index++) {
+        k.rockets[index]->setVelocity(sf::Vector2f(k.velocityX[index], k.velocityY[index]));
+    }
+}
+
+void GravitySimulator::applyGravityToRocketRange(size_t first, size_t last, float deltaTime)
+{
+    // Planets outer, rockets inner: each rocket still adds up its pulls in
+    // planet order, as applyGravityToRocket does, while the rockets side by
+    // side fill the vector lanes
+    const size_t planetCount = k.planetX.size();
+    size_t index = first;
+
+#ifdef GRAVITY_BATCH_SSE
+    const __m128 G = _mm_set1_ps(d);
+    const __m128 step = _mm_set1_ps(deltaTime);
+    for (; index + 4 <= last; index += 4) {
+        const __m128 x = _mm_loadu_ps(&k.positionX[index]);
+        const __m128 y = _mm_loadu_ps(&k.positionY[index]);
+        const __m128 mass = _mm_loadu_ps(&k.mass[index]);
+        __m128 velocityX = _mm_loadu_ps(&k.velocityX[index]);
+        __m128 velocityY = _mm_loadu_ps(&k.velocityY[index]);
+
+        for (size_t planet = 0; planet < planetCount; planet++) {
+            __m128 dx = _mm_sub_ps(_mm_set1_ps(k.planetX[planet]), x);
+            __m128 dy = _mm_sub_ps(_mm_set1_ps(k.planetY[planet]), y);
+            __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+            // Lanes too close to the planet compute garbage and are masked out
+            __m128 inReach = _mm_cmpgt_ps(dist, _mm_set1_ps(k.planetReach[planet]));
+            __m128 force = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(G, _mm_set1_ps(k.planetMass[planet])), mass), _mm_mul_ps(dist, dist));
+            __m128 changeX = _mm_mul_ps(_mm_div_ps(_mm_mul_ps(_mm_div_ps(dx, dist), force), mass), step);
+            __m128 changeY = _mm_mul_ps(_mm_div_ps(_mm_mul_ps(_mm_div_ps(dy, dist), force), mass), step);
+
+            velocityX = _mm_or_ps(_mm_and_ps(inReach, _mm_add_ps(velocityX, changeX)), _mm_andnot_ps(inReach, velocityX));
+            velocityY = _mm_or_ps(_mm_and_ps(inReach, _mm_add_ps(velocityY, changeY)), _mm_andnot_ps(inReach, velocityY));
+        }
+
+        _mm_storeu_ps(&k.velocityX[index], velocityX);
+        _mm_storeu_ps(&k.velocityY[index], velocityY);
+    }
+#endif
+
+    // Rockets left over after the last full group of four (or all of them without SSE)
+    for (; index < last; index++) {
+        for (size_t planet = 0; planet < planetCount; planet++) {
+            pullToward(k.planetX[planet], k.planetY[planet], k.planetMass[planet], k.planetReach[planet],
+                k.positionX[index], k.positionY[index], k.mass[index], d, deltaTime,
+                k.velocityX[index], k.velocityY[index]);
+        }
+    }
 }
 
 void GravitySimulator::addRocketGravityInteractions(float deltaTime)
@@ -202,59 +540,44 @@ void GravitySimulator::addRocketGravityInteractions(float deltaTime)
 void GravitySimulator::checkPlanetCollisions() {
     if (a.size() < 2) return;
 
-    std::vector<Planet*> keptPlanets;
-    std::vector<Planet*> removedPlanets;
-    std::vector<bool> markedForDeletion(a.size(), false);
-
-    // First pass: identify small planets to remove and do null checks
-    for (size_t i = 0; i < a.size(); i++) {
-        Planet* planet = a[i];
-        if (!planet) {
-            // Mark null planets for deletion
-            markedForDeletion[i] = true;
-            continue;
-        }
+    ProfileScope profile(ProfilePhase::PLANET_COLLISIONS);
+
+    // Planets are nulled in place as they're removed, so a null entry marks a
+    // deletion; the list is compacted at the end without a second vector
+    i.clear();
+
+    // First pass: identify small planets to remove
+    for (size_t k = 0; k < a.size(); k++) {
+        Planet* planet = a[k];
+        if (!planet) continue;
 
         // Only check planets we should simulate
         if (!shouldSimulateObject(planet->getOwnerId())) continue;
 
         // Check if the planet's mass is below threshold
         if (planet->getMass() < 10.0f) {
-            removedPlanets.push_back(planet);
-            markedForDeletion[i] = true;
-            a[i] = nullptr; // Explicitly set to nullptr
+            i.push_back(planet);
+            a[k] = nullptr;
         }
     }
 
-    // Second pass: check for collisions between non-deleted planets
-    for (size_t i = 0; i < a.size(); i++) {
-        if (markedForDeletion[i]) continue; // Skip already marked planets
-
-        Planet* p1 = a[i];
-        if (!p1) continue; // Extra safety check
+    // Second pass: check for collisions between remaining planets
+    for (size_t k = 0; k < a.size(); k++) {
+        Planet* p1 = a[k];
+        if (!p1) continue;
 
         // Only process planets we should simulate
         if (!shouldSimulateObject(p1->getOwnerId())) continue;
 
-        for (size_t j = i + 1; j < a.size(); j++) {
-            if (markedForDeletion[j]) continue; // Skip already marked planets
-
-            Planet* p2 = a[j];
-            if (!p2) continue; // Extra safety check
+        for (size_t m = k + 1; m < a.size(); m++) {
+            Planet* p2 = a[m];
+            if (!p2) continue;
 
             // Only process planets we should simulate
             if (!shouldSimulateObject(p2->getOwnerId())) continue;
 
-            // Calculate distance safely
-            sf::Vector2f dir;
-            try {
-                dir = p2->getPosition() - p1->getPosition();
-            }
-            catch (const std::exception& ex) {
-                std::cerr << "Exception calculating planet distance: " << ex.what() << std::endl;
-                continue; // Skip this pair
-            }
-
+            // Vector arithmetic can't throw, so no guard is needed per pair
+            sf::Vector2f dir = p2->getPosition() - p1->getPosition();
             float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
 
             // Check for collision
@@ -277,12 +600,9 @@ void GravitySimulator::checkPlanetCollisions() {
                         p1->setVelocity(newVel);
                         p1->setOwnerId(ownerId);
 
-                        // Mark planet 2 for deletion
-                        if (!markedForDeletion[j]) {
-                            removedPlanets.push_back(p2);
-                            markedForDeletion[j] = true;
-                            a[j] = nullptr; // Explicitly set to nullptr
-                        }
+                        // Remove planet 2
+                        i.push_back(p2);
+                        a[m] = nullptr;
                     }
                     else {
                         // Planet 2 absorbs planet 1
@@ -300,50 +620,42 @@ void GravitySimulator::checkPlanetCollisions() {
                         p2->setVelocity(newVel);
                         p2->setOwnerId(ownerId);
 
-                        // Mark planet 1 for deletion
-                        if (!markedForDeletion[i]) {
-                            removedPlanets.push_back(p1);
-                            markedForDeletion[i] = true;
-                            a[i] = nullptr; // Explicitly set to nullptr
-                        }
+                        // Remove planet 1
+                        i.push_back(p1);
+                        a[k] = nullptr;
                         break; // Exit inner loop since planet 1 is gone
                     }
                 }
                 catch (const std::exception& ex) {
-                    std::cerr << "Exception during planet collision: " << ex.what() << std::endl;
+                    KLOG_ERROR(PHYSICS, "exception", "where", "planetCollision", "error", ex.what());
                     continue; // Skip this pair if an exception occurs
                 }
             }
         }
     }
 
-    // Build the filtered list of planets to keep
-    for (size_t i = 0; i < a.size(); i++) {
-        if (!markedForDeletion[i] && a[i]) {
-            keptPlanets.push_back(a[i]);
-        }
-    }
+    // Nothing merged or shrank away: the list and everyone's copy of it still hold
+    size_t before = a.size();
+    a.erase(std::remove(a.begin(), a.end(), nullptr), a.end());
+    if (a.size() == before) return;
 
-    // Delete the marked planets safely
-    for (Planet* planet : removedPlanets) {
-        if (planet) { // Extra safety check
-            try {
-                delete planet;
-            }
-            catch (const std::exception& ex) {
-                std::cerr << "Exception deleting planet: " << ex.what() << std::endl;
-            }
+    // Delete the removed planets safely
+    for (Planet* planet : i) {
+        try {
+            delete planet;
+        }
+        catch (const std::exception& ex) {
+            KLOG_ERROR(PHYSICS, "exception", "where", "deletePlanet", "error", ex.what());
         }
     }
-
-    // Replace the planets vector with the filtered list
-    a = keptPlanets;
+    i.clear();
+    h++;
 
     // Update planets in vehicle manager
     try {
         updateVehicleManagerPlanets();
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception updating vehicle manager planets: " << ex.what() << std::endl;
+        KLOG_ERROR(PHYSICS, "exception", "where", "updateVehicleManagerPlanets", "error", ex.what());
     }
 }
\ No newline at end of file
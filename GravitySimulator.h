@@ -7,15 +7,44 @@
 #include <SFML/Graphics.hpp>
 // Forward declaration
 class VehicleManager;
+class JobSystem;
 
 class GravitySimulator {
 private:
+    // The batched rocket pass works on plain arrays: one lane per rocket,
+    // one entry per planet. Kept between ticks so it only ever grows
+    struct RocketBatch {
+        std::vector<Rocket*> rockets;
+        std::vector<float> positionX, positionY, velocityX, velocityY, mass;
+        std::vector<float> planetX, planetY, planetMass, planetReach;
+    };
+
+    // A planet as the held acceleration and jerk were taken from it
+    struct HeldPlanet {
+        const Planet* planet;
+        sf::Vector2f position, velocity;
+        float mass, radius;
+        int ownerId;
+    };
+
     std::vector<Planet*> a; // planets
     std::vector<Rocket*> b; // rockets
-    VehicleManager* c; // vehicleManager - used to update vehicles
+    std::vector<VehicleManager*> c; // vehicleManagers - every registered player, pulled by planets in one batch
     const float d; // G - gravitational constant
     bool e; // simulatePlanetGravity
     int f; // ownerId - which player this simulator belongs to (for filtering)
+    JobSystem* g; // jobs - optional worker pool for the planet gravity pass
+    unsigned long h; // planetVersion - bumped whenever a planet is added, removed or merged away
+    std::vector<Planet*> i; // removedPlanets - merge scratch, kept so collision checks don't allocate each tick
+    bool j; // simulateVehicleGravity - off when the owner calls applyGravityToVehicles itself
+    RocketBatch k; // rocketBatch - registered rockets and the planets, laid out for the batched pass
+    bool l; // blockTimesteps - planets move themselves in per-planet power-of-two substeps
+    std::vector<int> m; // planetLevels - this update's substep level per planet, -1 if it isn't pulled
+    std::vector<size_t> n; // endingPlanets - planets whose step ends with the current substep
+    unsigned int o; // substeps - finest substeps the last update split the tick into
+    std::vector<sf::Vector2f> p; // planetAccelerations - from the end of each planet's last step, for the next one's first kick
+    std::vector<sf::Vector2f> q; // planetJerks - taken with p at the end of each update, for choosing the next one's levels
+    std::vector<HeldPlanet> r; // heldPlanets - each planet as p and q were taken; any difference makes them stale
 
 public:
     GravitySimulator(int ownerId = -1);
@@ -24,24 +53,66 @@ public:
     void removePlanet(Planet* planet);
     void addRocket(Rocket* rocket);
     void removeRocket(Rocket* rocket);
-    void addVehicleManager(VehicleManager* manager) { c = manager; }
+    void addVehicleManager(VehicleManager* manager);
     void update(float deltaTime);
+
+    // Accelerate one rocket toward every planet - the step used by both server and client prediction
+    void applyGravityToRocket(Rocket* rocket, float deltaTime) const;
+
+    // Accelerate every registered player's rocket toward every planet in one
+    // pass over rockets x planets. Each rocket ends up with exactly the
+    // velocity applyGravityToRocket would give it
+    void applyGravityToVehicles(float deltaTime);
     void clearRockets();
 
     const std::vector<Planet*>& getPlanets() const { return a; }
+
+    // Changes only when the planet list does (not when planets move), so
+    // holders of a copy can tell when it's stale
+    unsigned long getPlanetVersion() const { return h; }
     const std::vector<Rocket*>& getRockets() const { return b; }
     void setSimulatePlanetGravity(bool enable) { e = enable; }
 
+    // Give each planet its own power-of-two share of every update, picked from
+    // its acceleration and jerk at the start of the update, with all of them
+    // back in step at the end. The simulator then moves the planets as well,
+    // so the owner must not call Planet::update on them
+    void setBlockTimesteps(bool enable) { l = enable; }
+    bool getBlockTimesteps() const { return l; }
+    unsigned int getSubstepCount() const { return o; }
+
+    // The acceleration and jerk every planet ended the last block update
+    // with. The next update starts from them instead of another pull pass
+    // while the planets are exactly as that update left them, so they are
+    // part of the simulation state: a rollback has to hold them again for the
+    // re-simulation to choose the same levels
+    bool hasHeldSteps() const;
+    sf::Vector2f getHeldAcceleration(size_t index) const { return p[index]; }
+    sf::Vector2f getHeldJerk(size_t index) const { return q[index]; }
+    void holdStep(size_t index, sf::Vector2f acceleration, sf::Vector2f jerk);
+    void dropHeldSteps() { r.clear(); }
+
+    // With this off, update leaves registered vehicles alone and the owner
+    // calls applyGravityToVehicles at the point in its tick it needs
+    void setSimulateVehicleGravity(bool enable) { j = enable; }
+
     // Set owner ID to limit simulation to owned objects
-    void setOwnerId(int id) { f = id; }
+    void setOwnerId(int id) { f = id; r.clear(); }
     int getOwnerId() const { return f; }
     bool shouldSimulateObject(int objectOwnerId) const;
 
-    void removeVehicleManager(VehicleManager* manager) { if (c == manager) { c = nullptr; } }
+    void removeVehicleManager(VehicleManager* manager);
+    const std::vector<VehicleManager*>& getVehicleManagers() const { return c; }
+
+    // Split the planet and rocket gravity passes into jobs (nullptr runs them serially)
+    void setJobSystem(JobSystem* jobs) { g = jobs; }
 
 private:
     void applyGravityBetweenPlanets(float deltaTime);
-    void applyGravityToRockets(float deltaTime);
+    void stepPlanetsInBlocks(float deltaTime);
+    void holdPlanet(size_t index);
+    sf::Vector2f planetAcceleration(size_t index, sf::Vector2f* jerk) const;
+    void applyGravityToRocketRange(size_t first, size_t last, float deltaTime);
     void addRocketGravityInteractions(float deltaTime);
     void checkPlanetCollisions();
     void updateVehicleManagerPlanets();
@@ -0,0 +1,192 @@
+// JobSystem.cpp
+#include "JobSystem.h"
+#include "TraceRecorder.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Which deque the current thread owns (workers only)
+    thread_local const JobSystem* tlsOwner = nullptr;
+    thread_local size_t tlsQueue = 0;
+}
+
+TaskGroup::TaskGroup(JobSystem& jobs)
+    : a(jobs), b(0)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    // Jobs hold a pointer to the group, so never let it go while any are queued
+    wait();
+}
+
+void TaskGroup::run(std::function<void()> job)
+{
+    b++;
+
+    // No workers - just run it now
+    if (a.b.empty()) {
+        JobSystem::Job immediate{ std::move(job), this };
+        a.execute(immediate);
+        return;
+    }
+
+    a.push(JobSystem::Job{ std::move(job), this });
+}
+
+void TaskGroup::wait()
+{
+    while (b > 0) {
+        // Help out rather than block; if nothing is runnable our jobs are in flight elsewhere
+        if (!a.runOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+JobSystem::JobSystem(unsigned int threadCount)
+    : c(true), d(0)
+{
+    for (unsigned int i = 0; i <= threadCount; i++) {
+        a.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++) {
+        b.emplace_back(&JobSystem::workerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(e);
+        c = false;
+    }
+    f.notify_all();
+
+    for (auto& worker : b) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+unsigned int JobSystem::defaultThreadCount()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+size_t JobSystem::currentQueue() const
+{
+    // Non-worker threads share the last deque
+    return tlsOwner == this ? tlsQueue : a.size() - 1;
+}
+
+void JobSystem::push(Job&& job)
+{
+    WorkerQueue& queue = *a[currentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.a);
+        queue.b.push_back(std::move(job));
+    }
+    d++;
+
+    // A wakeup that races past a worker going to sleep costs at most its sleep timeout
+    f.notify_one();
+}
+
+bool JobSystem::popOwn(size_t index, Job& out)
+{
+    WorkerQueue& queue = *a[index];
+    std::lock_guard<std::mutex> lock(queue.a);
+    if (queue.b.empty()) return false;
+
+    out = std::move(queue.b.back());
+    queue.b.pop_back();
+    d--;
+    return true;
+}
+
+bool JobSystem::steal(size_t thief, Job& out)
+{
+    size_t count = a.size();
+    for (size_t offset = 1; offset < count; offset++) {
+        WorkerQueue& queue = *a[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.a);
+        if (queue.b.empty()) continue;
+
+        out = std::move(queue.b.front());
+        queue.b.pop_front();
+        d--;
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job)
+{
+    TraceScope trace("job");
+    try {
+        job.work();
+    }
+    catch (const std::exception& ex) {
+        KLOG_ERROR(GAME, "exception", "where", "job", "error", ex.what());
+    }
+    catch (...) {
+        KLOG_ERROR(GAME, "exception", "where", "job", "error", "unknown");
+    }
+
+    job.group->b--;
+}
+
+bool JobSystem::runOne()
+{
+    size_t index = currentQueue();
+    Job job;
+    if (popOwn(index, job) || steal(index, job)) {
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(size_t index)
+{
+    tlsOwner = this;
+    tlsQueue = index;
+    TraceRecorder::setThreadName("job worker");
+
+    while (c) {
+        if (runOne()) continue;
+
+        // Nothing anywhere - sleep until a push, with a timeout in case a wakeup races past us
+        std::unique_lock<std::mutex> lock(e);
+        f.wait_for(lock, std::chrono::milliseconds(1), [this]() { return d > 0 || !c; });
+    }
+}
+
+void JobSystem::parallelFor(size_t first, size_t last, size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+    if (first >= last) return;
+    if (grain == 0) grain = 1;
+
+    // Small ranges or no workers: not worth forking
+    if (b.empty() || last - first <= grain) {
+        body(first, last);
+        return;
+    }
+
+    TaskGroup group(*this);
+
+    // Queue all chunks but the first, then work on the first while others steal
+    for (size_t begin = first + grain; begin < last; begin += grain) {
+        size_t end = std::min(begin + grain, last);
+        group.run([&body, begin, end]() { body(begin, end); });
+    }
+
+    body(first, std::min(first + grain, last));
+    group.wait();
+}
\ No newline at end of file
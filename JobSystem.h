@@ -0,0 +1,96 @@
+// JobSystem.h
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+class JobSystem;
+
+// A set of jobs that can be waited on together (fork/join).
+// The thread that waits helps run queued jobs instead of blocking, so
+// groups can be nested: a job may fork its own group and wait on it.
+class TaskGroup {
+private:
+    JobSystem& a; // jobs
+    std::atomic<int> b; // pending - jobs queued or running
+
+    friend class JobSystem;
+
+public:
+    explicit TaskGroup(JobSystem& jobs);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Fork: queue a job on the calling thread's deque
+    void run(std::function<void()> job);
+
+    // Join: run or steal jobs until every job in this group has finished
+    void wait();
+};
+
+// Small work-stealing scheduler.
+//
+// Every worker owns a deque: it pushes and pops its own jobs at the back
+// (newest first, still hot in cache) and idle workers steal from the front
+// of someone else's (oldest first, usually the biggest pieces). Threads that
+// aren't workers - the tick thread, room workers - share one extra deque.
+// Each deque has its own small mutex; jobs are coarse (a range of players or
+// bodies), so the locks are not contended in practice.
+class JobSystem {
+public:
+    struct Job {
+        std::function<void()> work;
+        TaskGroup* group;
+    };
+
+private:
+    struct WorkerQueue {
+        std::mutex a; // mutex
+        std::deque<Job> b; // jobs
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> a; // queues - one per worker, plus the shared one last
+    std::vector<std::thread> b; // workers
+    std::atomic<bool> c; // running
+    std::atomic<int> d; // queued - jobs sitting in any deque
+    std::mutex e; // sleepMutex
+    std::condition_variable f; // wakeUp
+
+    void workerLoop(size_t index);
+    size_t currentQueue() const;
+    bool popOwn(size_t index, Job& out);
+    bool steal(size_t thief, Job& out);
+    void execute(Job& job);
+
+    friend class TaskGroup;
+    void push(Job&& job);
+    bool runOne();
+
+public:
+    // threadCount is the number of extra worker threads; 0 leaves all work
+    // on the calling thread, which makes every primitive run serially
+    explicit JobSystem(unsigned int threadCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(b.size()); }
+    int getQueuedCount() const { return d.load(std::memory_order_relaxed); }
+
+    // Call body(begin, end) over [first, last) in chunks of at most grain items,
+    // spread over the workers and the calling thread; returns when all are done.
+    // With no workers the whole range goes to one call on the calling thread
+    void parallelFor(size_t first, size_t last, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    // Workers to use by default: one per core, minus the calling thread
+    static unsigned int defaultThreadCount();
+};
\ No newline at end of file
@@ -0,0 +1,497 @@
+// LoadGen.cpp
+// Load generator: runs a server and hundreds of headless bots in one process
+// on localhost and reports how the server holds up.
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <csignal>
+#include <SFML/Network.hpp>
+#include "ServerLogger.h"
+#include "ServerConfig.h"
+#include "ClientManager.h"
+#include "NetworkManager.h"
+#include "GameServer.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "GameClient.h"
+#include "BotClient.h"
+#include "TickScheduler.h"
+#include "SnapshotPipeline.h"
+#include "RoomManager.h"
+
+#ifdef _DEBUG
+#pragma comment(lib, "sfml-system-d.lib")
+#pragma comment(lib, "sfml-network-d.lib")
+#pragma comment(lib, "sfml-window-d.lib")
+#pragma comment(lib, "sfml-graphics-d.lib")
+#else
+#pragma comment(lib, "sfml-system.lib")
+#pragma comment(lib, "sfml-network.lib")
+#pragma comment(lib, "sfml-window.lib")
+#pragma comment(lib, "sfml-graphics.lib")
+#endif
+
+// Global flag for early shutdown
+std::atomic<bool> running(true);
+
+void signalHandler(int) {
+    running = false;
+}
+
+struct LoadGenOptions {
+    int bots = 100;
+    int threads = 4;
+    float duration = 30.0f;
+    BotScript script = BotScript::RANDOM;
+    float inputRate = 30.0f;
+    int predictedBots = 4;
+    std::string connectAddress;   // Empty runs the server in-process
+    unsigned short port = 5100;
+    float updateRate = GameConstants::SERVER_UPDATE_RATE;
+    bool pipelined = true;
+    int rooms = 1;
+    int jobThreads = -1;          // -1 picks one per spare core
+};
+
+// What the in-process server measured while the bots were connected
+struct ServerSamples {
+    std::mutex mutex;
+    std::vector<float> tickTimes;   // receive + update + snapshot + send, seconds
+    std::vector<float> tickIntervals;
+    size_t peakPlayers = 0;
+    unsigned long overruns = 0;
+    PhaseTiming workerSend;      // snapshot worker, when pipelined
+    PhaseTiming freezeToSent;
+    unsigned long superseded = 0;
+};
+
+void parseCommandLine(int argc, char* argv[], LoadGenOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--bots" && i + 1 < argc) {
+            options.bots = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--duration" && i + 1 < argc) {
+            options.duration = std::stof(argv[++i]);
+        }
+        else if (arg == "--script" && i + 1 < argc) {
+            std::string script = argv[++i];
+            if (script == "idle") options.script = BotScript::IDLE;
+            else if (script == "orbit") options.script = BotScript::ORBIT;
+            else options.script = BotScript::RANDOM;
+        }
+        else if (arg == "--input-rate" && i + 1 < argc) {
+            options.inputRate = std::stof(argv[++i]);
+        }
+        else if (arg == "--predict" && i + 1 < argc) {
+            options.predictedBots = std::max(0, std::stoi(argv[++i]));
+        }
+        else if (arg == "--connect" && i + 1 < argc) {
+            options.connectAddress = argv[++i];
+        }
+        else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<unsigned short>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--update-rate" && i + 1 < argc) {
+            options.updateRate = std::stof(argv[++i]);
+        }
+        else if (arg == "--rooms" && i + 1 < argc) {
+            options.rooms = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--job-threads" && i + 1 < argc) {
+            options.jobThreads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--serial-broadcast") {
+            options.pipelined = false;
+        }
+        else if (arg == "--help") {
+            std::cout << "KatieLoadGen - Headless bot load generator" << std::endl;
+            std::cout << "Usage: KatieLoadGen [options]" << std::endl;
+            std::cout << "Options:" << std::endl;
+            std::cout << "  --bots NUM           Number of simulated players (default: 100)" << std::endl;
+            std::cout << "  --threads NUM        Threads driving the bots (default: 4)" << std::endl;
+            std::cout << "  --duration SECONDS   How long to run once connected (default: 30)" << std::endl;
+            std::cout << "  --script NAME        idle, orbit or random (default: random)" << std::endl;
+            std::cout << "  --input-rate HZ      Inputs each bot sends per second (default: 30)" << std::endl;
+            std::cout << "  --predict NUM        Bots that run full client prediction (default: 4)" << std::endl;
+            std::cout << "  --connect HOST       Use a running server instead of an in-process one" << std::endl;
+            std::cout << "  --port PORT          Server port (default: 5100)" << std::endl;
+            std::cout << "  --update-rate RATE   In-process server update rate in seconds (default: 0.05)" << std::endl;
+            std::cout << "  --serial-broadcast   In-process server sends snapshots on the tick thread" << std::endl;
+            std::cout << "  --rooms NUM          Spread bots over NUM rooms (in-process server hosts them)" << std::endl;
+            std::cout << "  --job-threads NUM    In-process server tick workers (default: one per spare core)" << std::endl;
+            std::cout << "  --help               Display this help message" << std::endl;
+            exit(0);
+        }
+    }
+}
+
+// Nearest-rank percentile of an already sorted vector
+float percentile(const std::vector<float>& sorted, float fraction) {
+    if (sorted.empty()) return 0.0f;
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5f);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void printDistribution(const std::string& name, std::vector<float> values, float scale, const std::string& unit) {
+    std::sort(values.begin(), values.end());
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2);
+    if (values.empty()) {
+        std::cout << "no samples" << std::endl;
+        return;
+    }
+    std::cout << "p50 " << percentile(values, 0.50f) * scale << unit
+        << "  p90 " << percentile(values, 0.90f) * scale << unit
+        << "  p99 " << percentile(values, 0.99f) * scale << unit
+        << "  max " << values.back() * scale << unit
+        << "  (" << values.size() << " samples)" << std::endl;
+}
+
+// Multi-room server: rooms tick on their own workers, this thread only polls the network
+void runRoomServer(ServerConfig& config, std::atomic<bool>& serverRunning, std::atomic<bool>& serverReady) {
+    ServerLogger logger(config.getLogFile(), false);
+    Log::ScopedSink logSink(logger);
+    ClientManager clientManager(logger, config);
+    NetworkManager networkManager(clientManager, logger, config);
+    RoomManager roomManager(networkManager, logger, config);
+    roomManager.start();
+
+    if (!networkManager.start()) {
+        logger.error("Failed to start network manager");
+        roomManager.stop();
+        serverRunning = false;
+        return;
+    }
+    serverReady = true;
+
+    while (serverRunning) {
+        networkManager.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    roomManager.logStats();
+    roomManager.stop();
+    networkManager.stop();
+}
+
+// Same loop as the standalone server, timing each tick
+void runServer(const LoadGenOptions& options, ServerConfig& config, std::atomic<bool>& serverRunning,
+    std::atomic<bool>& serverReady, std::atomic<bool>& measuring, ServerSamples& samples) {
+    ServerLogger logger(config.getLogFile(), false);
+    Log::ScopedSink logSink(logger);
+    ClientManager clientManager(logger, config);
+    NetworkManager networkManager(clientManager, logger, config);
+    GameServer gameServer(logger, config);
+    gameServer.initialize();
+
+    JobSystem jobs(config.getJobThreads() >= 0 ?
+        static_cast<unsigned int>(config.getJobThreads()) : JobSystem::defaultThreadCount());
+    gameServer.setJobSystem(&jobs);
+
+    networkManager.setPlayerInputCallback([&gameServer](int clientId, const PlayerInput& input) {
+        gameServer.handlePlayerInput(clientId, input);
+        });
+
+    networkManager.setClientDisconnectedCallback([&gameServer](int clientId) {
+        gameServer.handlePlayerDisconnect(clientId);
+        });
+
+    networkManager.setClientAuthenticatedCallback([&gameServer](int clientId, const std::string&) {
+        gameServer.addPlayer(clientId);
+        });
+
+    networkManager.onClientSimulationReceived = [&gameServer](int clientId, const GameState& clientState) {
+        gameServer.processClientSimulation(clientId, clientState);
+        };
+
+    if (!networkManager.start()) {
+        logger.error("Failed to start network manager");
+        serverRunning = false;
+        return;
+    }
+    serverReady = true;
+
+    TickScheduler scheduler(config.getUpdateRate(), config.getMaxCatchUpSteps());
+    SnapshotPipeline pipeline(networkManager);
+    GameState snapshot;
+    std::vector<int> corrections;
+    size_t players = 0;
+
+    if (config.isPipelinedBroadcast()) {
+        pipeline.start();
+    }
+
+    scheduler.setReceivePhase([&networkManager]() {
+        networkManager.update();
+        });
+
+    scheduler.setSimulationPhase([&gameServer](float deltaTime) {
+        gameServer.update(deltaTime);
+        });
+
+    scheduler.setBroadcastPhase([&config, &gameServer, &networkManager, &pipeline, &snapshot, &corrections, &players]() {
+        snapshot = gameServer.getGameState();
+        gameServer.takeCorrections(corrections);
+        players = snapshot.c.size();
+
+        if (config.isPipelinedBroadcast()) {
+            pipeline.publish(snapshot, corrections);
+        }
+        else {
+            networkManager.sendGameState(snapshot, corrections);
+        }
+        });
+
+    bool wasMeasuring = false;
+
+    while (serverRunning) {
+        int steps = scheduler.runFrame();
+
+        // Worker statistics only count from the start of the measurement
+        if (measuring != wasMeasuring) {
+            wasMeasuring = measuring;
+            if (wasMeasuring) {
+                pipeline.logStats(logger);
+            }
+            else {
+                std::lock_guard<std::mutex> lock(samples.mutex);
+                samples.workerSend = pipeline.getSendTiming();
+                samples.freezeToSent = pipeline.getLatencyTiming();
+                samples.superseded = pipeline.getSupersededCount();
+            }
+        }
+
+        if (measuring && steps > 0) {
+            float tickTime = 0.0f;
+            for (int phase = 0; phase < static_cast<int>(TickPhase::COUNT); phase++) {
+                tickTime += scheduler.getPhaseTiming(static_cast<TickPhase>(phase)).lastSeconds;
+            }
+
+            std::lock_guard<std::mutex> lock(samples.mutex);
+            samples.tickTimes.push_back(tickTime);
+            samples.tickIntervals.push_back(scheduler.getLastFrameInterval());
+            samples.overruns += scheduler.getLastOverrun() > 0.0f ? 1 : 0;
+            samples.peakPlayers = std::max(samples.peakPlayers, players);
+        }
+    }
+
+    gameServer.logValidationStats(options.duration);
+    pipeline.stop();
+    networkManager.stop();
+}
+
+// Drive a share of the bots until told to stop
+void runBots(std::vector<std::unique_ptr<BotClient>>& bots, size_t first, size_t last,
+    const sf::IpAddress& address, unsigned short port, std::atomic<bool>& botsRunning,
+    std::atomic<int>& connected, std::atomic<int>& survivors) {
+    auto start = std::chrono::steady_clock::now();
+    auto now = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+
+    for (size_t i = first; i < last && botsRunning; i++) {
+        if (bots[i]->connect(address, port)) {
+            connected++;
+        }
+        else {
+            std::cerr << "Bot " << i << " failed to connect" << std::endl;
+        }
+        // Keep servicing the bots already in so they don't time out while the rest connect
+        for (size_t j = first; j <= i; j++) {
+            bots[j]->update(now());
+        }
+    }
+
+    while (botsRunning) {
+        double time = now();
+        for (size_t i = first; i < last; i++) {
+            bots[i]->update(time);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (size_t i = first; i < last; i++) {
+        if (bots[i]->isConnected()) survivors++;
+        bots[i]->disconnect();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    LoadGenOptions options;
+    parseCommandLine(argc, argv, options);
+
+    bool embedded = options.connectAddress.empty();
+
+    ServerConfig config;
+    config.setPort(options.port);
+    config.setMaxClients(options.bots + 1);
+    config.setUpdateRate(options.updateRate);
+    config.setVerbose(false);
+    config.setLogFile("loadgen_server_log.txt");
+    config.setPipelinedBroadcast(options.pipelined);
+    config.setRoomCount(options.rooms);
+    config.setJobThreads(options.jobThreads);
+
+    std::atomic<bool> serverRunning(true);
+    std::atomic<bool> serverReady(false);
+    std::atomic<bool> measuring(false);
+    ServerSamples samples;
+    std::thread serverThread;
+
+    if (embedded && options.rooms > 1) {
+        serverThread = std::thread(runRoomServer, std::ref(config), std::ref(serverRunning), std::ref(serverReady));
+    }
+    else if (embedded) {
+        serverThread = std::thread(runServer, std::cref(options), std::ref(config), std::ref(serverRunning),
+            std::ref(serverReady), std::ref(measuring), std::ref(samples));
+    }
+
+    if (embedded) {
+        while (!serverReady && serverRunning) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!serverRunning) {
+            serverThread.join();
+            std::cerr << "Server failed to start on port " << options.port << std::endl;
+            return 1;
+        }
+    }
+
+    auto resolved = sf::IpAddress::resolve(embedded ? "127.0.0.1" : options.connectAddress);
+    if (!resolved) {
+        std::cerr << "Could not resolve " << options.connectAddress << std::endl;
+        serverRunning = false;
+        if (serverThread.joinable()) serverThread.join();
+        return 1;
+    }
+
+    // Bots that run full prediction are spread evenly over the population
+    std::vector<std::unique_ptr<BotClient>> bots;
+    bots.reserve(options.bots);
+    int predictEvery = options.predictedBots > 0 ? std::max(1, options.bots / options.predictedBots) : 0;
+    for (int i = 0; i < options.bots; i++) {
+        bool predict = predictEvery > 0 && i % predictEvery == 0 && i / predictEvery < options.predictedBots;
+        bots.push_back(std::make_unique<BotClient>(i, options.script, options.inputRate, predict));
+        if (options.rooms > 1) {
+            bots.back()->setRequestedRoom(i % options.rooms);
+        }
+    }
+
+    std::cout << "Connecting " << options.bots << " bots to " << resolved->toString() << ":" << options.port
+        << " on " << options.threads << " threads..." << std::endl;
+
+    std::atomic<bool> botsRunning(true);
+    std::atomic<int> connected(0);
+    std::atomic<int> survivors(0);
+    std::vector<std::thread> botThreads;
+    int threadCount = std::min(options.threads, options.bots);
+    for (int t = 0; t < threadCount; t++) {
+        size_t first = static_cast<size_t>(options.bots) * t / threadCount;
+        size_t last = static_cast<size_t>(options.bots) * (t + 1) / threadCount;
+        botThreads.emplace_back(runBots, std::ref(bots), first, last, *resolved, options.port,
+            std::ref(botsRunning), std::ref(connected), std::ref(survivors));
+    }
+
+    // Give the connections up to ten seconds, then measure for the requested duration
+    auto connectStart = std::chrono::steady_clock::now();
+    while (running && connected < options.bots &&
+        std::chrono::steady_clock::now() - connectStart < std::chrono::seconds(10)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::cout << connected << " bots connected, measuring for " << options.duration << " seconds..." << std::endl;
+
+    measuring = true;
+    auto measureStart = std::chrono::steady_clock::now();
+    while (running && std::chrono::duration<float>(std::chrono::steady_clock::now() - measureStart).count() < options.duration) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - measureStart).count();
+    measuring = false;
+
+    botsRunning = false;
+    for (auto& thread : botThreads) {
+        thread.join();
+    }
+    serverRunning = false;
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+
+    // Combine what the bots saw
+    BotStats total;
+    unsigned long reconciles = 0;
+    float maxPredictionError = 0.0f;
+    double predictionErrorSum = 0.0;
+    for (const auto& bot : bots) {
+        const BotStats& stats = bot->getStats();
+        total.a += stats.a;
+        total.b += stats.b;
+        total.c += stats.c;
+        total.d += stats.d;
+        total.e += stats.e;
+        total.f = std::max(total.f, stats.f);
+        total.g.insert(total.g.end(), stats.g.begin(), stats.g.end());
+
+        if (const GameClient* predictor = bot->getPredictor()) {
+            const PredictionBuffer& prediction = predictor->getPrediction();
+            reconciles += prediction.getReconcileCount();
+            predictionErrorSum += prediction.getAverageCorrection() * prediction.getReconcileCount();
+            maxPredictionError = std::max(maxPredictionError, prediction.getMaxCorrection());
+        }
+    }
+
+    std::cout << std::endl << "=== Load test: " << options.bots << " bots, " << std::fixed << std::setprecision(1)
+        << elapsed << " s, ";
+    if (options.rooms > 1) {
+        std::cout << options.rooms << " rooms ===" << std::endl;
+    }
+    else {
+        std::cout << (options.pipelined ? "pipelined" : "serial") << " broadcast ===" << std::endl;
+    }
+
+    if (embedded && options.rooms == 1) {
+        std::lock_guard<std::mutex> lock(samples.mutex);
+        std::cout << "Peak players in snapshot: " << samples.peakPlayers << std::endl;
+        printDistribution("Server tick time", samples.tickTimes, 1000.0f, " ms");
+        printDistribution("Server tick interval", samples.tickIntervals, 1000.0f, " ms");
+        std::cout << "Tick overruns:        " << samples.overruns << std::endl;
+        if (options.pipelined) {
+            std::cout << std::setprecision(2)
+                << "Snapshot worker:      send avg " << samples.workerSend.averageSeconds() * 1000.0f << " ms"
+                << ", max " << samples.workerSend.maxSeconds * 1000.0f << " ms"
+                << "; freeze-to-sent avg " << samples.freezeToSent.averageSeconds() * 1000.0f << " ms"
+                << ", max " << samples.freezeToSent.maxSeconds * 1000.0f << " ms"
+                << "; " << samples.superseded << " superseded" << std::endl;
+        }
+    }
+
+    std::cout << std::setprecision(0);
+    std::cout << "Snapshots received:   " << total.a << " (" << total.a / std::max(elapsed, 0.001f) << "/s across all bots)" << std::endl;
+    std::cout << "Snapshot size:        avg " << (total.a ? total.e / total.a : 0) << " bytes, max " << total.f << " bytes" << std::endl;
+    std::cout << "Inputs sent:          " << total.c << ", send failures " << total.d << std::endl;
+    printDistribution("Input latency", total.g, 1000.0f, " ms");
+    std::cout << std::setprecision(2);
+    std::cout << "Corrections:          " << total.b << " (" << total.b / std::max(elapsed, 0.001f) << "/s, "
+        << (total.a ? 100.0 * total.b / total.a : 0.0) << "% of snapshots)" << std::endl;
+    if (reconciles > 0) {
+        std::cout << "Prediction error:     avg " << predictionErrorSum / reconciles << ", max " << maxPredictionError
+            << " over " << reconciles << " reconciles" << std::endl;
+    }
+    std::cout << "Bots still connected: " << survivors << "/" << options.bots << std::endl;
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Log.cpp
+#include "Log.h"
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+    std::atomic<ServerLogger*> sink(nullptr);
+
+    bool needsQuotes(const char* text, size_t length) {
+        if (length == 0) return true;
+        for (size_t i = 0; i < length; i++) {
+            char c = text[i];
+            if (c == ' ' || c == '=' || c == '"' || c == '\\' || c == '\n' || c == '\t') return true;
+        }
+        return false;
+    }
+
+    void appendText(std::string& out, const char* text, size_t length) {
+        if (!needsQuotes(text, length)) {
+            out.append(text, length);
+            return;
+        }
+
+        out += '"';
+        for (size_t i = 0; i < length; i++) {
+            char c = text[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            }
+            else if (c == '\n') {
+                out += "\\n";
+            }
+            else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+}
+
+namespace Log {
+    void setSink(ServerLogger* logger) {
+        sink = logger;
+    }
+
+    ServerLogger* getSink() {
+        return sink;
+    }
+
+    bool isEnabled(ServerLogger::Level level) {
+        ServerLogger* logger = sink.load(std::memory_order_relaxed);
+        return logger ? logger->isEnabled(level) : true;
+    }
+
+    const char* categoryName(LogCategory category) {
+        switch (category) {
+        case LogCategory::NET:     return "net";
+        case LogCategory::GAME:    return "game";
+        case LogCategory::PHYSICS: return "physics";
+        case LogCategory::VEHICLE: return "vehicle";
+        }
+        return "unknown";
+    }
+
+    void emit(ServerLogger::Level level, const std::string& line) {
+        ServerLogger* logger = sink.load(std::memory_order_acquire);
+        if (logger) {
+            logger->log(level, line);
+        }
+        else {
+            std::cerr << line << std::endl;
+        }
+    }
+
+    void appendValue(std::string& out, const std::string& value) {
+        appendText(out, value.data(), value.size());
+    }
+
+    void appendValue(std::string& out, const char* value) {
+        if (!value) value = "";
+        appendText(out, value, std::char_traits<char>::length(value));
+    }
+
+    void appendValue(std::string& out, bool value) {
+        out += value ? "true" : "false";
+    }
+
+    void appendValue(std::string& out, double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%g", value);
+        out += buffer;
+    }
+
+    void appendValue(std::string& out, const sf::Vector2f& value) {
+        appendValue(out, value.x);
+        out += ',';
+        appendValue(out, value.y);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+// Log.h
+#pragma once
+#include <string>
+#include <type_traits>
+#include <SFML/Graphics.hpp>
+#include "ServerLogger.h"
+
+// Structured logging for the game and network code.
+//
+//     KLOG_INFO(NET, "client_connected", "client", clientId, "address", ip);
+//
+// writes "event=client_connected cat=net client=7 address=10.0.0.2" through
+// ServerLogger. Fields are key, value pairs; strings with spaces are quoted.
+//
+// Levels below KATIE_LOG_MIN_LEVEL and categories missing from
+// KATIE_LOG_CATEGORIES are compiled out: the arguments are never evaluated
+// and no code is generated. What is compiled in is checked against the
+// logger's runtime level before any string is built.
+
+// 0 debug, 1 info, 2 warning, 3 error. Release builds drop debug by default
+#ifndef KATIE_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define KATIE_LOG_MIN_LEVEL 0
+#else
+#define KATIE_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+// Bitmask of LogCategory values to keep
+#ifndef KATIE_LOG_CATEGORIES
+#define KATIE_LOG_CATEGORIES 0xFFFFFFFFu
+#endif
+
+enum class LogCategory : unsigned int {
+    NET = 1u << 0,
+    GAME = 1u << 1,
+    PHYSICS = 1u << 2,
+    VEHICLE = 1u << 3
+};
+
+namespace Log {
+    constexpr int severity(ServerLogger::Level level) {
+        return level == ServerLogger::Level::DEBUG ? 0 :
+            level == ServerLogger::Level::INFO ? 1 :
+            level == ServerLogger::Level::WARNING ? 2 : 3;
+    }
+
+    constexpr bool isCompiledIn(ServerLogger::Level level, LogCategory category) {
+        return severity(level) >= KATIE_LOG_MIN_LEVEL &&
+            (static_cast<unsigned int>(category) & KATIE_LOG_CATEGORIES) != 0;
+    }
+
+    // Where records go. Without a sink (client-side code, tools) they go to std::cerr
+    void setSink(ServerLogger* logger);
+    ServerLogger* getSink();
+
+    // Routes records to a logger while in scope; declare it right after the logger
+    class ScopedSink {
+    private:
+        ServerLogger* a; // previous - sink to put back on the way out
+
+    public:
+        explicit ScopedSink(ServerLogger& logger) : a(getSink()) { setSink(&logger); }
+        ~ScopedSink() { setSink(a); }
+
+        ScopedSink(const ScopedSink&) = delete;
+        ScopedSink& operator=(const ScopedSink&) = delete;
+    };
+
+    bool isEnabled(ServerLogger::Level level);
+    const char* categoryName(LogCategory category);
+    void emit(ServerLogger::Level level, const std::string& line);
+
+    void appendValue(std::string& out, const std::string& value);
+    void appendValue(std::string& out, const char* value);
+    void appendValue(std::string& out, bool value);
+    void appendValue(std::string& out, double value);
+    void appendValue(std::string& out, const sf::Vector2f& value);
+
+    inline void appendValue(std::string& out, float value) {
+        appendValue(out, static_cast<double>(value));
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_integral<T>::value> appendValue(std::string& out, T value) {
+        out += std::to_string(value);
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_enum<T>::value> appendValue(std::string& out, T value) {
+        out += std::to_string(static_cast<long long>(value));
+    }
+
+    inline void appendFields(std::string&) {}
+
+    template<typename V, typename... Rest>
+    void appendFields(std::string& out, const char* key, const V& value, const Rest&... rest) {
+        out += ' ';
+        out += key;
+        out += '=';
+        appendValue(out, value);
+        appendFields(out, rest...);
+    }
+
+    template<typename... Fields>
+    void write(ServerLogger::Level level, LogCategory category, const char* event, const Fields&... fields) {
+        static_assert(sizeof...(Fields) % 2 == 0, "log fields come in key, value pairs");
+
+        std::string line;
+        line.reserve(128);
+        line += "event=";
+        line += event;
+        line += " cat=";
+        line += categoryName(category);
+        appendFields(line, fields...);
+        emit(level, line);
+    }
+}
+
+#define KATIE_LOG(level, category, event, ...) \
+    do { \
+        if constexpr (Log::isCompiledIn(level, category)) { \
+            if (Log::isEnabled(level)) { \
+                Log::write(level, category, event, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define KLOG_DEBUG(category, event, ...) KATIE_LOG(ServerLogger::Level::DEBUG, LogCategory::category, event, ##__VA_ARGS__)
+#define KLOG_INFO(category, event, ...) KATIE_LOG(ServerLogger::Level::INFO, LogCategory::category, event, ##__VA_ARGS__)
+#define KLOG_WARN(category, event, ...) KATIE_LOG(ServerLogger::Level::WARNING, LogCategory::category, event, ##__VA_ARGS__)
+#define KLOG_ERROR(category, event, ...) KATIE_LOG(ServerLogger::Level::ERROR, LogCategory::category, event, ##__VA_ARGS__)
\ No newline at end of file
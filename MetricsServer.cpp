@@ -0,0 +1,313 @@
+// MetricsServer.cpp
+#include "MetricsServer.h"
+#include "ServerMetrics.h"
+#include "ServerLogger.h"
+#include "JobSystem.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    // Prometheus bucket bounds for the tick histograms, in seconds. The
+    // TickProfiler keeps far finer buckets; these are summed from them
+    const double BUCKET_BOUNDS[] = {
+        0.000025, 0.00005, 0.0001, 0.00025, 0.0005,
+        0.001, 0.0025, 0.005, 0.01, 0.0167, 0.025, 0.05, 0.1, 0.25, 1.0
+    };
+
+    void appendf(std::string& out, const char* format, ...) {
+        char line[256];
+        va_list args;
+        va_start(args, format);
+        int length = std::vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (length > 0) {
+            out.append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+        }
+    }
+
+    void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+        appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+
+    // "GET <path>" or "GET <path>?..." as the request line
+    bool isRequestFor(const char* request, size_t length, const char* path) {
+        const char method[] = "GET ";
+        size_t methodLength = sizeof(method) - 1;
+        size_t pathLength = std::strlen(path);
+        if (length <= methodLength + pathLength) return false;
+        if (std::memcmp(request, method, methodLength) != 0) return false;
+        if (std::memcmp(request + methodLength, path, pathLength) != 0) return false;
+        char next = request[methodLength + pathLength];
+        return next == ' ' || next == '?';
+    }
+}
+
+MetricsServer::MetricsServer(NetworkManager& network, ServerLogger& logger)
+    : a(network), b(logger), c(nullptr), d(nullptr), f(false)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+bool MetricsServer::start(unsigned short port)
+{
+    if (e.listen(port, sf::IpAddress::LocalHost) != sf::Socket::Status::Done) {
+        b.error("Metrics endpoint failed to listen on port " + std::to_string(port));
+        return false;
+    }
+
+    e.setBlocking(false);
+    f = true;
+
+    // Reserve what a typical scrape needs up front
+    h.reserve(64 * 1024);
+    i.reserve(256);
+
+    b.info("Metrics endpoint on http://127.0.0.1:" + std::to_string(port) + "/metrics");
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (!f) return;
+
+    for (auto& connection : g) {
+        close(connection);
+    }
+    e.close();
+    f = false;
+}
+
+void MetricsServer::poll()
+{
+    if (!f) return;
+
+    acceptConnections();
+    for (auto& connection : g) {
+        if (connection.b) {
+            service(connection);
+        }
+    }
+}
+
+void MetricsServer::acceptConnections()
+{
+    // With every slot busy, new scrapers wait in the listen backlog
+    for (auto& connection : g) {
+        if (connection.b) continue;
+
+        connection.a.setBlocking(false);
+        if (e.accept(connection.a) != sf::Socket::Status::Done) return;
+
+        connection.a.setBlocking(false);
+        connection.b = true;
+        connection.d = 0;
+        connection.e.clear();
+        connection.f = 0;
+        connection.g = Clock::now();
+    }
+}
+
+void MetricsServer::service(Connection& connection)
+{
+    if (connection.e.empty()) {
+        // Still reading the request head
+        size_t received = 0;
+        sf::Socket::Status status = connection.a.receive(connection.c + connection.d,
+            REQUEST_SIZE - connection.d, received);
+
+        if (status == sf::Socket::Status::Done) {
+            connection.d += received;
+        }
+        else if (status != sf::Socket::Status::NotReady) {
+            close(connection);
+            return;
+        }
+
+        bool complete = false;
+        for (size_t index = 3; index < connection.d && !complete; index++) {
+            complete = std::memcmp(connection.c + index - 3, "\r\n\r\n", 4) == 0;
+        }
+
+        if (complete || connection.d == REQUEST_SIZE) {
+            respond(connection);
+        }
+        else {
+            std::chrono::duration<float> waited = Clock::now() - connection.g;
+            if (waited.count() > CONNECTION_TIMEOUT) {
+                close(connection);
+            }
+            return;
+        }
+    }
+
+    size_t sent = 0;
+    sf::Socket::Status status = connection.a.send(connection.e.data() + connection.f,
+        connection.e.size() - connection.f, sent);
+    connection.f += sent;
+
+    if (status == sf::Socket::Status::Done || (status != sf::Socket::Status::Partial && status != sf::Socket::Status::NotReady)) {
+        close(connection);
+    }
+}
+
+void MetricsServer::close(Connection& connection)
+{
+    if (!connection.b) return;
+
+    connection.a.disconnect();
+    connection.b = false;
+}
+
+void MetricsServer::respond(Connection& connection)
+{
+    const char* status = "200 OK";
+    h.clear();
+
+    if (isRequestFor(connection.c, connection.d, "/metrics")) {
+        renderMetrics(h);
+    }
+    else if (d && isRequestFor(connection.c, connection.d, "/trace/start")) {
+        d->start();
+        h += "Trace recording started\n";
+    }
+    else if (d && isRequestFor(connection.c, connection.d, "/trace/stop")) {
+        if (d->stop()) {
+            h += "Trace written to " + d->getPath() + "\n";
+        }
+        else {
+            status = "409 Conflict";
+            h += "No trace was written (not recording, or the file failed)\n";
+        }
+    }
+    else {
+        status = "404 Not Found";
+        h += "Try /metrics, /trace/start or /trace/stop\n";
+    }
+
+    connection.e.clear();
+    appendf(connection.e,
+        "HTTP/1.1 %s\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: %zu\r\n"
+        "Connection: close\r\n\r\n",
+        status, h.size());
+    connection.e += h;
+    connection.f = 0;
+}
+
+void MetricsServer::renderMetrics(std::string& out)
+{
+    ServerMetrics& metrics = ServerMetrics::global();
+
+    TickProfiler* profiler = TickProfiler::current();
+    if (profiler) {
+        renderHistograms(out, *profiler);
+    }
+
+    appendHeader(out, "katie_players", "gauge", "Players in all rooms");
+    appendf(out, "katie_players %lld\n", static_cast<long long>(metrics.players.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_bodies", "gauge", "Bodies simulated each tick");
+    appendf(out, "katie_bodies{kind=\"planet\"} %lld\n", static_cast<long long>(metrics.planets.load(std::memory_order_relaxed)));
+    appendf(out, "katie_bodies{kind=\"vehicle\"} %lld\n", static_cast<long long>(metrics.vehicles.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_validations_total", "counter", "Client simulations checked against the server");
+    appendf(out, "katie_validations_total %llu\n", static_cast<unsigned long long>(metrics.validations.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_corrections_total", "counter", "Corrections sent; divide by validations for the correction rate");
+    appendf(out, "katie_corrections_total %llu\n", static_cast<unsigned long long>(metrics.corrections.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_corrections_deferred_total", "counter", "Corrections held back by the per-player rate limit");
+    appendf(out, "katie_corrections_deferred_total %llu\n", static_cast<unsigned long long>(metrics.correctionsDeferred.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_queue_depth", "gauge", "Work waiting in internal queues");
+    appendf(out, "katie_queue_depth{queue=\"validations\"} %lld\n", static_cast<long long>(metrics.pendingValidations.load(std::memory_order_relaxed)));
+    appendf(out, "katie_queue_depth{queue=\"corrections\"} %lld\n", static_cast<long long>(metrics.pendingCorrections.load(std::memory_order_relaxed)));
+    appendf(out, "katie_queue_depth{queue=\"log\"} %zu\n", b.getQueueDepth());
+    if (c) {
+        appendf(out, "katie_queue_depth{queue=\"jobs\"} %d\n", c->getQueuedCount());
+    }
+
+    appendHeader(out, "katie_log_dropped_total", "counter", "Log messages dropped because the log ring was full");
+    appendf(out, "katie_log_dropped_total %lu\n", b.getDroppedCount());
+
+    appendHeader(out, "katie_connections_accepted_total", "counter", "Client connections accepted");
+    appendf(out, "katie_connections_accepted_total %llu\n", static_cast<unsigned long long>(metrics.connectionsAccepted.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_bytes_received_total", "counter", "Bytes received from all clients");
+    appendf(out, "katie_bytes_received_total %llu\n", static_cast<unsigned long long>(metrics.bytesReceived.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_bytes_sent_total", "counter", "Bytes sent to all clients");
+    appendf(out, "katie_bytes_sent_total %llu\n", static_cast<unsigned long long>(metrics.bytesSent.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "katie_send_failures_total", "counter", "Sends that did not complete (the packet loss counter)");
+    appendf(out, "katie_send_failures_total %d\n", a.getPacketLoss());
+
+    renderTraffic(out);
+}
+
+void MetricsServer::renderHistograms(std::string& out, TickProfiler& profiler)
+{
+    const int boundCount = static_cast<int>(sizeof(BUCKET_BOUNDS) / sizeof(BUCKET_BOUNDS[0]));
+
+    appendHeader(out, "katie_phase_duration_seconds", "histogram", "Time spent in each phase of the server tick");
+    for (int phase = 0; phase < static_cast<int>(ProfilePhase::COUNT); phase++) {
+        const char* name = TickProfiler::phaseName(static_cast<ProfilePhase>(phase));
+        profiler.getHistogram(static_cast<ProfilePhase>(phase)).snapshot(j);
+
+        // Both lists are sorted, so one walk sums the fine buckets under each bound
+        uint64_t cumulative = 0;
+        int bucket = 0;
+        for (int bound = 0; bound < boundCount; bound++) {
+            uint64_t limit = static_cast<uint64_t>(BUCKET_BOUNDS[bound] * 1e9);
+            while (bucket < HistogramSnapshot::BUCKET_COUNT && HistogramSnapshot::bucketUpperBound(bucket) <= limit) {
+                cumulative += j.counts[bucket++];
+            }
+            appendf(out, "katie_phase_duration_seconds_bucket{phase=\"%s\",le=\"%g\"} %llu\n",
+                name, BUCKET_BOUNDS[bound], static_cast<unsigned long long>(cumulative));
+        }
+        appendf(out, "katie_phase_duration_seconds_bucket{phase=\"%s\",le=\"+Inf\"} %llu\n",
+            name, static_cast<unsigned long long>(j.count));
+        appendf(out, "katie_phase_duration_seconds_sum{phase=\"%s\"} %.9f\n", name, j.sumNanos / 1e9);
+        appendf(out, "katie_phase_duration_seconds_count{phase=\"%s\"} %llu\n",
+            name, static_cast<unsigned long long>(j.count));
+    }
+
+    appendHeader(out, "katie_phase_over_budget_total", "counter", "Phases that took longer than their budget");
+    for (int phase = 0; phase < static_cast<int>(ProfilePhase::COUNT); phase++) {
+        appendf(out, "katie_phase_over_budget_total{phase=\"%s\"} %llu\n",
+            TickProfiler::phaseName(static_cast<ProfilePhase>(phase)),
+            static_cast<unsigned long long>(profiler.getOverBudgetCount(static_cast<ProfilePhase>(phase))));
+    }
+}
+
+void MetricsServer::renderTraffic(std::string& out)
+{
+    a.getClientTraffic(i);
+    if (i.empty()) return;
+
+    appendHeader(out, "katie_client_bytes_received_total", "counter", "Bytes received from each open connection");
+    for (const auto& client : i) {
+        appendf(out, "katie_client_bytes_received_total{client=\"%d\"} %llu\n",
+            client.clientId, static_cast<unsigned long long>(client.bytesReceived));
+    }
+
+    appendHeader(out, "katie_client_bytes_sent_total", "counter", "Bytes sent to each open connection");
+    for (const auto& client : i) {
+        appendf(out, "katie_client_bytes_sent_total{client=\"%d\"} %llu\n",
+            client.clientId, static_cast<unsigned long long>(client.bytesSent));
+    }
+
+    appendHeader(out, "katie_client_send_failures_total", "counter", "Sends to each open connection that did not complete");
+    for (const auto& client : i) {
+        appendf(out, "katie_client_send_failures_total{client=\"%d\"} %llu\n",
+            client.clientId, static_cast<unsigned long long>(client.sendFailures));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// MetricsServer.h
+#pragma once
+#include <SFML/Network.hpp>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "NetworkManager.h"
+#include "TickProfiler.h"
+
+class ServerLogger;
+class JobSystem;
+class TraceRecorder;
+
+// Serves GET /metrics in the Prometheus text format on a local port, plus
+// the admin commands GET /trace/start and GET /trace/stop when a trace
+// recorder is attached.
+//
+// There is no thread of its own: the server loop calls poll() between ticks,
+// which accepts, reads and answers without ever blocking. A scrape builds the
+// page into per-connection buffers that keep their capacity, so after the
+// first few scrapes serving allocates nothing, and the tick itself only ever
+// touches the atomics in ServerMetrics, the TickProfiler and NetworkManager.
+class MetricsServer {
+public:
+    static constexpr int MAX_CONNECTIONS = 4;
+    static constexpr size_t REQUEST_SIZE = 2048;      // longest request head accepted
+    static constexpr float CONNECTION_TIMEOUT = 2.0f; // seconds a scraper may take to send its request
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        sf::TcpSocket a; // socket
+        bool b = false; // open
+        char c[REQUEST_SIZE]; // request
+        size_t d = 0; // received
+        std::string e; // response - empty until the request is complete
+        size_t f = 0; // sent
+        Clock::time_point g; // openedAt
+    };
+
+    NetworkManager& a; // network
+    ServerLogger& b; // logger
+    JobSystem* c; // jobs - optional, for the queue depth
+    TraceRecorder* d; // tracer - optional, for the trace commands
+
+    sf::TcpListener e; // listener
+    bool f; // listening
+    Connection g[MAX_CONNECTIONS]; // connections
+
+    // Scratch reused by every scrape
+    std::string h; // body
+    std::vector<ClientTraffic> i; // traffic
+    HistogramSnapshot j; // histogram
+
+    void acceptConnections();
+    void service(Connection& connection);
+    void close(Connection& connection);
+    void respond(Connection& connection);
+
+    void renderMetrics(std::string& out);
+    void renderHistograms(std::string& out, TickProfiler& profiler);
+    void renderTraffic(std::string& out);
+
+public:
+    MetricsServer(NetworkManager& network, ServerLogger& logger);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Listen on 127.0.0.1:port; false if the port can't be bound
+    bool start(unsigned short port);
+    void stop();
+
+    // Report the job system's queue depth as well (optional)
+    void setJobSystem(JobSystem* jobSystem) { c = jobSystem; }
+    // Accept the trace admin commands (optional)
+    void setTraceRecorder(TraceRecorder* recorder) { d = recorder; }
+
+    // Make progress on every scrape without blocking; call once per loop iteration
+    void poll();
+};
\ No newline at end of file
@@ -5,16 +5,18 @@
 #include "ClientManager.h"
 #include "ServerLogger.h"
 #include "ServerConfig.h"
-#include "GameConstants.h"
+#include "Log.h"
+#include "TickProfiler.h"
+#include "ServerMetrics.h"
+#include "TraceRecorder.h"
 #include <sstream>
 #include <chrono>
 #include <thread>
-#include <iostream>
 #include <algorithm>
 
 NetworkManager::NetworkManager(ClientManager& clientManager, ServerLogger& logger, ServerConfig& config)
     : a(true), // Always true for server application
-    e(0), f(false), g(nullptr), h(nullptr),
+    x(1), e(0), f(false), g(nullptr), h(nullptr),
     j(0), k(0), l(ConnectionState::DISCONNECTED), m(0.1f),
     p(clientManager), q(logger), r(config)
 {
@@ -30,6 +32,8 @@ NetworkManager::NetworkManager(ClientManager& clientManager, ServerLogger& logge
     s = nullptr;
     t = nullptr;
     u = nullptr;
+    z = nullptr;
+    onRoomJoined = nullptr;
 }
 
 NetworkManager::~NetworkManager()
@@ -38,10 +42,10 @@ NetworkManager::~NetworkManager()
         disconnect();
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in NetworkManager destructor: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "~NetworkManager", "error", ex.what());
     }
     catch (...) {
-        std::cerr << "Unknown exception in NetworkManager destructor" << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "~NetworkManager", "error", "unknown");
     }
 }
 
@@ -64,33 +68,33 @@ bool NetworkManager::hostGame(unsigned short port)
 
         // Start listening for connections
         if (d.listen(port) != sf::Socket::Status::Done) {
-            std::cerr << "Failed to bind to port " << port << std::endl;
+            KLOG_ERROR(NET, "bind_failed", "port", port);
             l = ConnectionState::DISCONNECTED;
             return false;
         }
 
-        std::cout << "Server started on port " << port << std::endl;
+        KLOG_INFO(NET, "server_started", "port", port);
 
         // Log IP addresses
         auto localIp = sf::IpAddress::getLocalAddress();
         if (localIp) {
-            std::cout << "Local IP address: " << localIp->toString() << std::endl;
+            KLOG_INFO(NET, "local_address", "ip", localIp->toString());
         }
         else {
-            std::cout << "Could not determine local IP address" << std::endl;
+            KLOG_WARN(NET, "local_address_unknown");
         }
 
         try {
             auto publicIp = sf::IpAddress::getPublicAddress(sf::seconds(2));
             if (publicIp) {
-                std::cout << "Public IP address: " << publicIp->toString() << std::endl;
+                KLOG_INFO(NET, "public_address", "ip", publicIp->toString());
             }
             else {
-                std::cout << "Could not determine public IP address" << std::endl;
+                KLOG_WARN(NET, "public_address_unknown");
             }
         }
         catch (const std::exception& ex) {
-            std::cerr << "Error getting public IP: " << ex.what() << std::endl;
+            KLOG_ERROR(NET, "exception", "where", "publicAddress", "error", ex.what());
         }
 
         d.setBlocking(false);
@@ -99,7 +103,7 @@ bool NetworkManager::hostGame(unsigned short port)
         return true;
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in hostGame: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "hostGame", "error", ex.what());
         f = false;
         l = ConnectionState::DISCONNECTED;
         return false;
@@ -112,7 +116,7 @@ bool NetworkManager::joinGame(const sf::IpAddress& address, unsigned short port)
         a = false;
         l = ConnectionState::CONNECTING;
 
-        std::cout << "Connecting to " << address.toString() << ":" << port << "..." << std::endl;
+        KLOG_INFO(NET, "connecting", "address", address.toString(), "port", port);
 
         // Set timeout for connection attempts
         c.setBlocking(true);
@@ -120,19 +124,19 @@ bool NetworkManager::joinGame(const sf::IpAddress& address, unsigned short port)
         c.setBlocking(false);
 
         if (status != sf::Socket::Status::Done) {
-            std::cerr << "Failed to connect to " << address.toString() << ":" << port << std::endl;
+            KLOG_ERROR(NET, "connect_failed", "address", address.toString(), "port", port);
             l = ConnectionState::DISCONNECTED;
             return false;
         }
 
-        std::cout << "Successfully connected to server!" << std::endl;
+        KLOG_INFO(NET, "connected", "address", address.toString(), "port", port);
         f = true;
         l = ConnectionState::AUTHENTICATING; // Move to authenticating until we get player ID
         i.restart();
         return true;
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in joinGame: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "joinGame", "error", ex.what());
         f = false;
         l = ConnectionState::DISCONNECTED;
         return false;
@@ -156,13 +160,14 @@ bool NetworkManager::sendClientSimulation(const GameState& clientState)
         return true;
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in sendClientSimulation: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "sendClientSimulation", "error", ex.what());
         return false;
     }
 }
 
 bool NetworkManager::sendServerValidation(const GameState& validatedState, int clientId)
 {
+    std::lock_guard<std::recursive_mutex> lock(v);
     if (!a || !f) return false;
 
     try {
@@ -170,42 +175,41 @@ bool NetworkManager::sendServerValidation(const GameState& validatedState, int c
         packet << static_cast<uint32_t>(static_cast<int>(MessageType::SERVER_VALIDATION)) << validatedState;
 
         // Find the client socket matching the ID
-        if (clientId <= 0 || clientId > static_cast<int>(b.size())) {
-            std::cerr << "Invalid client ID in sendServerValidation: " << clientId << std::endl;
+        auto slot = std::find(w.begin(), w.end(), clientId);
+        if (slot == w.end()) {
+            KLOG_ERROR(NET, "invalid_client", "where", "sendServerValidation", "client", clientId);
             return false;
         }
 
-        sf::TcpSocket* clientSocket = b[clientId - 1]; // Client IDs are 1-based, array is 0-based
+        size_t index = static_cast<size_t>(slot - w.begin());
+        sf::TcpSocket* clientSocket = b[index];
         if (!clientSocket) {
-            std::cerr << "Null client socket for ID: " << clientId << std::endl;
+            KLOG_ERROR(NET, "null_socket", "where", "sendServerValidation", "client", clientId);
             return false;
         }
 
-        sf::Socket::Status status = clientSocket->send(packet);
-        if (status != sf::Socket::Status::Done) {
-            j++;
-            return false;
-        }
-
-        return true;
+        return recordSend(index, packet, clientSocket->send(packet));
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in sendServerValidation: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "sendServerValidation", "error", ex.what());
         return false;
     }
 }
 
 void NetworkManager::update()
 {
+    TraceScope trace("network_update");
+    std::lock_guard<std::recursive_mutex> lock(v);
     try {
         if (!f) {
             // Return early if we're not connected
             return;
         }
 
-        // Check for timeouts (5 seconds without data)
-        if (i.getElapsedTime().asSeconds() > 5.0f) {
-            std::cerr << "Connection timed out - no data received for 5 seconds" << std::endl;
+        // Check for timeouts (5 seconds without data) - client only, the server
+        // must keep listening even when nobody is connected
+        if (!a && i.getElapsedTime().asSeconds() > 5.0f) {
+            KLOG_WARN(NET, "connection_timeout", "idle_seconds", 5);
             disconnect();
             return;
         }
@@ -218,12 +222,9 @@ void NetworkManager::update()
                 heartbeatPacket << static_cast<uint32_t>(static_cast<int>(MessageType::HEARTBEAT));
 
                 if (a) {
-                    for (auto client : b) {
-                        if (client) {
-                            sf::Socket::Status status = client->send(heartbeatPacket);
-                            if (status != sf::Socket::Status::Done) {
-                                j++;
-                            }
+                    for (size_t index = 0; index < b.size(); index++) {
+                        if (b[index]) {
+                            recordSend(index, heartbeatPacket, b[index]->send(heartbeatPacket));
                         }
                     }
                 }
@@ -235,70 +236,66 @@ void NetworkManager::update()
                 }
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception sending heartbeat: " << ex.what() << std::endl;
+                KLOG_ERROR(NET, "exception", "where", "heartbeat", "error", ex.what());
             }
 
             heartbeatClock.restart();
         }
 
         if (a) {
-            // Server mode: accept new connections
+            // Server mode: accept every pending connection
             try {
-                sf::TcpSocket* newClient = new sf::TcpSocket();
-                sf::Socket::Status status = d.accept(*newClient);
-
-                if (status == sf::Socket::Status::Done) {
-                    newClient->setBlocking(false);
+                while (true) {
+                    sf::TcpSocket* newClient = new sf::TcpSocket();
+                    sf::Socket::Status status = d.accept(*newClient);
 
-                    // Log connection info
-                    if (auto remoteAddress = newClient->getRemoteAddress()) {
-                        std::cout << "New client connecting from: " << remoteAddress->toString() << std::endl;
-                    }
-                    else {
-                        std::cout << "New client connecting from: unknown address" << std::endl;
-                    }
+                    if (status == sf::Socket::Status::Done) {
+                        newClient->setBlocking(false);
 
-                    b.push_back(newClient);
+                        // Log connection info
+                        if (auto remoteAddress = newClient->getRemoteAddress()) {
+                            KLOG_INFO(NET, "client_connecting", "address", remoteAddress->toString());
+                        }
+                        else {
+                            KLOG_INFO(NET, "client_connecting", "address", "unknown");
+                        }
 
-                    // Create a unique ID for the client (use client index + 1 to avoid ID 0)
-                    int clientId = static_cast<int>(b.size()); // This will be 1 for the first client
+                        // Create a unique ID for the client; IDs are never reused, so they stay
+                        // valid when other clients disconnect (the first client gets 1)
+                        int clientId = x++;
+                        b.push_back(newClient);
+                        w.push_back(clientId);
+                        aa.push_back(ClientTraffic{ clientId, 0, 0, 0 });
+                        ServerMetrics::global().connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
+
+                        // Send player ID to the client
+                        sf::Packet idPacket;
+                        idPacket << static_cast<uint32_t>(static_cast<int>(MessageType::PLAYER_ID)) << static_cast<uint32_t>(clientId);
+                        if (!recordSend(b.size() - 1, idPacket, newClient->send(idPacket))) {
+                            KLOG_ERROR(NET, "send_failed", "message", "player_id", "client", clientId);
+                        }
 
-                    // Send player ID to the client
-                    sf::Packet idPacket;
-                    idPacket << static_cast<uint32_t>(static_cast<int>(MessageType::PLAYER_ID)) << static_cast<uint32_t>(clientId);
-                    sf::Socket::Status sendStatus = newClient->send(idPacket);
+                        // Create a new player for this client if gameServer exists
+                        if (g) {
+                            g->addPlayer(clientId, g->getClientSpawnPosition(), sf::Color::Red);
+                        }
 
-                    if (sendStatus != sf::Socket::Status::Done) {
-                        std::cerr << "Failed to send player ID to client" << std::endl;
-                    }
+                        KLOG_INFO(NET, "client_connected", "client", clientId);
 
-                    // Create a new player for this client if gameServer exists
-                    if (g) {
-                        const auto& planets = g->getPlanets();
-                        if (!planets.empty() && planets[0]) {
-                            sf::Vector2f spawnPos = planets[0]->getPosition() +
-                                sf::Vector2f(0, -(planets[0]->getRadius() + GameConstants::ROCKET_SIZE + 30.0f));
-                            g->addPlayer(clientId, spawnPos, sf::Color::Red);
-                        }
-                        else {
-                            g->addPlayer(clientId, sf::Vector2f(400.f, 100.f), sf::Color::Red);
+                        // Call the authentication callback
+                        if (u) {
+                            u(clientId, "Player_" + std::to_string(clientId));
                         }
                     }
-
-                    std::cout << "New client connected with ID: " << clientId << std::endl;
-
-                    // Call the authentication callback
-                    if (u) {
-                        u(clientId, "Player_" + std::to_string(clientId));
+                    else {
+                        // No new connection, clean up allocated socket
+                        delete newClient;
+                        break;
                     }
                 }
-                else {
-                    // No new connection, clean up allocated socket
-                    delete newClient;
-                }
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception accepting new connection: " << ex.what() << std::endl;
+                KLOG_ERROR(NET, "exception", "where", "accept", "error", ex.what());
             }
 
             // Check for messages from clients
@@ -310,98 +307,124 @@ void NetworkManager::update()
                 }
 
                 try {
-                    sf::Packet packet;
-                    sf::Socket::Status status = client->receive(packet);
-
-                    if (status == sf::Socket::Status::Done) {
-                        if (packet.getDataSize() > 0) {
-                            uint32_t msgType;
-                            if (packet >> msgType) {
-                                // Client ID is index+1
-                                int clientId = static_cast<int>(i + 1);
-
-                                switch (static_cast<MessageType>(msgType)) {
-                                case MessageType::PLAYER_INPUT:
-                                {
-                                    PlayerInput input;
-                                    if (packet >> input) {
-                                        // Override the player ID with the client ID for security
-                                        input.a = clientId;
-
-                                        if (onPlayerInputReceived) {
-                                            onPlayerInputReceived(clientId, input);
-                                        }
-
-                                        // Call the callback
-                                        if (s) {
-                                            s(clientId, input);
+                    // Drain everything this client has sent since the last update
+                    while (b[i]) {
+                        sf::Packet packet;
+                        sf::Socket::Status status = client->receive(packet);
+
+                        if (status == sf::Socket::Status::Done) {
+                            uint64_t received = packet.getDataSize() + sizeof(uint32_t);
+                            aa[i].bytesReceived += received;
+                            ServerMetrics::global().bytesReceived.fetch_add(received, std::memory_order_relaxed);
+
+                            if (packet.getDataSize() > 0) {
+                                uint32_t msgType;
+                                if (packet >> msgType) {
+                                    int clientId = w[i];
+
+                                    switch (static_cast<MessageType>(msgType)) {
+                                    case MessageType::PLAYER_INPUT:
+                                    {
+                                        PlayerInput input;
+                                        if (packet >> input) {
+                                            // Override the player ID with the client ID for security
+                                            input.a = clientId;
+
+                                            if (onPlayerInputReceived) {
+                                                onPlayerInputReceived(clientId, input);
+                                            }
+
+                                            // Call the callback
+                                            if (s) {
+                                                s(clientId, input);
+                                            }
                                         }
+                                        break;
                                     }
-                                    break;
-                                }
-                                case MessageType::CLIENT_SIMULATION:
-                                {
-                                    GameState clientState;
-                                    if (packet >> clientState) {
-                                        if (onClientSimulationReceived) {
-                                            onClientSimulationReceived(clientId, clientState);
+                                    case MessageType::CLIENT_SIMULATION:
+                                    {
+                                        GameState clientState;
+                                        if (packet >> clientState) {
+                                            if (onClientSimulationReceived) {
+                                                onClientSimulationReceived(clientId, clientState);
+                                            }
                                         }
+                                        break;
                                     }
-                                    break;
-                                }
-                                case MessageType::DISCONNECT:
-                                    std::cout << "Client " << clientId << " requested disconnect" << std::endl;
-                                    // Handle client disconnect - clean up client socket and game resources
-                                    client->disconnect();
-                                    delete client;
-                                    b[i] = nullptr;
-
-                                    if (g) {
-                                        g->removePlayer(clientId);
+                                    case MessageType::JOIN_ROOM:
+                                    {
+                                        uint32_t roomId;
+                                        if (packet >> roomId && z) {
+                                            z(clientId, static_cast<int>(roomId));
+                                        }
+                                        break;
                                     }
+                                    case MessageType::DISCONNECT:
+                                        KLOG_INFO(NET, "client_disconnect_requested", "client", clientId);
+                                        // Handle client disconnect - clean up client socket and game resources
+                                        client->disconnect();
+                                        delete client;
+                                        b[i] = nullptr;
+
+                                        if (g) {
+                                            g->removePlayer(clientId);
+                                        }
 
-                                    // Call the disconnection callback
-                                    if (t) {
-                                        t(clientId);
-                                    }
-                                    break;
+                                        // Call the disconnection callback
+                                        if (t) {
+                                            t(clientId);
+                                        }
+                                        forgetClient(clientId);
+                                        break;
 
-                                default:
-                                    std::cerr << "Received unknown message type from client: " << msgType << std::endl;
-                                    break;
+                                    default:
+                                        KLOG_WARN(NET, "unknown_message", "client", clientId, "type", msgType);
+                                        break;
+                                    }
                                 }
                             }
                         }
-                    }
-                    else if (status == sf::Socket::Status::Disconnected) {
-                        int clientId = static_cast<int>(i + 1);
-                        std::cout << "Client " << clientId << " disconnected" << std::endl;
+                        else if (status == sf::Socket::Status::Disconnected) {
+                            int clientId = w[i];
+                            KLOG_INFO(NET, "client_disconnected", "client", clientId);
 
-                        // Clean up client socket and game resources
-                        delete client;
-                        b[i] = nullptr;
+                            // Clean up client socket and game resources
+                            delete client;
+                            b[i] = nullptr;
 
-                        if (g) {
-                            g->removePlayer(clientId);
-                        }
+                            if (g) {
+                                g->removePlayer(clientId);
+                            }
 
-                        // Call the disconnection callback
-                        if (t) {
-                            t(clientId);
+                            // Call the disconnection callback
+                            if (t) {
+                                t(clientId);
+                            }
+                            forgetClient(clientId);
+                        }
+                        else {
+                            break;
                         }
                     }
                 }
                 catch (const std::exception& ex) {
-                    std::cerr << "Exception processing client message: " << ex.what() << std::endl;
+                    KLOG_ERROR(NET, "exception", "where", "clientMessage", "error", ex.what());
                 }
             }
 
-            // Remove null client pointers from the vector
-            b.erase(
-                std::remove_if(b.begin(), b.end(),
-                    [](sf::TcpSocket* client) { return client == nullptr; }),
-                b.end()
-            );
+            // Remove null client pointers, keeping each ID next to its socket
+            size_t kept = 0;
+            for (size_t i = 0; i < b.size(); i++) {
+                if (b[i]) {
+                    b[kept] = b[i];
+                    w[kept] = w[i];
+                    aa[kept] = aa[i];
+                    kept++;
+                }
+            }
+            b.resize(kept);
+            w.resize(kept);
+            aa.resize(kept);
         }
         else {
             // Client mode - improved error handling
@@ -421,17 +444,17 @@ void NetworkManager::update()
                             uint32_t playerId;
                             if (packet >> playerId) {
                                 if (h) {
-                                    std::cout << "Received player ID from server: " << playerId << std::endl;
+                                    KLOG_INFO(NET, "player_id_received", "player", playerId);
 
                                     // Set the player ID and update connection state
                                     h->setLocalPlayerId(static_cast<int>(playerId));
 
                                     // Explicitly transition to waiting for state
                                     l = ConnectionState::CONNECTED;
-                                    std::cout << "Connection state updated to waiting for game state" << std::endl;
+                                    KLOG_DEBUG(NET, "connection_state", "state", "waiting_for_game_state");
                                 }
                                 else {
-                                    std::cerr << "Error: Received player ID but gameClient is null" << std::endl;
+                                    KLOG_ERROR(NET, "player_id_without_client", "player", playerId);
                                 }
                             }
                         }
@@ -446,16 +469,27 @@ void NetworkManager::update()
                             GameState state;
                             try {
                                 if (packet >> state) {
-                                    if (onGameStateReceived && h) {
+                                    // Trailing flag marks a server correction of our simulation
+                                    bool corrected = false;
+                                    if (!packet.endOfPacket() && !(packet >> corrected)) {
+                                        corrected = false;
+                                    }
+
+                                    if (corrected && onServerValidationReceived && h) {
+                                        // Server overrides our state with this snapshot
+                                        state.e = true;
+                                        onServerValidationReceived(state);
+                                    }
+                                    else if (onGameStateReceived && h) {
                                         onGameStateReceived(state);
                                     }
                                 }
                                 else {
-                                    std::cerr << "Failed to parse game state packet" << std::endl;
+                                    KLOG_ERROR(NET, "parse_failed", "message", "game_state");
                                 }
                             }
                             catch (const std::exception& ex) {
-                                std::cerr << "Exception parsing game state: " << ex.what() << std::endl;
+                                KLOG_ERROR(NET, "exception", "where", "parseGameState", "error", ex.what());
                             }
                         }
                         break;
@@ -469,35 +503,46 @@ void NetworkManager::update()
                                     }
                                 }
                                 else {
-                                    std::cerr << "Failed to parse server validation packet" << std::endl;
+                                    KLOG_ERROR(NET, "parse_failed", "message", "server_validation");
                                 }
                             }
                             catch (const std::exception& ex) {
-                                std::cerr << "Exception parsing server validation: " << ex.what() << std::endl;
+                                KLOG_ERROR(NET, "exception", "where", "parseServerValidation", "error", ex.what());
                             }
                         }
                         break;
                         case MessageType::HEARTBEAT:
                             // Just a keep-alive, no action needed
                             break;
+                        case MessageType::ROOM_JOINED:
+                        {
+                            uint32_t roomId;
+                            if (packet >> roomId) {
+                                KLOG_INFO(NET, "room_joined", "room", roomId);
+                                if (onRoomJoined) {
+                                    onRoomJoined(static_cast<int>(roomId));
+                                }
+                            }
+                        }
+                        break;
                         case MessageType::DISCONNECT:
-                            std::cout << "Disconnected from server" << std::endl;
+                            KLOG_INFO(NET, "server_disconnected");
                             f = false;
                             l = ConnectionState::DISCONNECTED;
                             c.disconnect();
                             break;
                         default:
-                            std::cerr << "Received unknown message type: " << msgType << std::endl;
+                            KLOG_WARN(NET, "unknown_message", "type", msgType);
                             break;
                         }
                     }
                     else {
-                        std::cerr << "Failed to read message type from packet" << std::endl;
+                        KLOG_ERROR(NET, "parse_failed", "message", "message_type");
                     }
                 }
             }
             else if (status == sf::Socket::Status::Disconnected) {
-                std::cout << "Lost connection to server" << std::endl;
+                KLOG_WARN(NET, "connection_lost");
                 f = false;
                 l = ConnectionState::DISCONNECTED;
             }
@@ -515,15 +560,16 @@ void NetworkManager::update()
         }
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in update: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "update", "error", ex.what());
     }
     catch (...) {
-        std::cerr << "Unknown exception in update" << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "update", "error", "unknown");
     }
 }
 
 void NetworkManager::disconnect()
 {
+    std::lock_guard<std::recursive_mutex> lock(v);
     try {
         if (f) {
             // Send disconnect message
@@ -565,6 +611,9 @@ void NetworkManager::disconnect()
                 }
             }
             b.clear();
+            w.clear();
+            aa.clear();
+            y.clear();
         }
         else {
             try {
@@ -577,16 +626,16 @@ void NetworkManager::disconnect()
 
         f = false;
         l = ConnectionState::DISCONNECTED;
-        std::cout << "Disconnected from network" << std::endl;
+        KLOG_INFO(NET, "disconnected");
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in disconnect: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "disconnect", "error", ex.what());
         // Force disconnect state even if there was an error
         f = false;
         l = ConnectionState::DISCONNECTED;
     }
     catch (...) {
-        std::cerr << "Unknown exception in disconnect" << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "disconnect", "error", "unknown");
         // Force disconnect state even if there was an error
         f = false;
         l = ConnectionState::DISCONNECTED;
@@ -609,34 +658,164 @@ void NetworkManager::enableRobustNetworking()
         }
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in enableRobustNetworking: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "enableRobustNetworking", "error", ex.what());
     }
 }
 
-bool NetworkManager::sendGameState(const GameState& state)
+bool NetworkManager::sendGameState(const GameState& state, const std::vector<int>& corrections)
 {
-    if (!a || !f) return false;
+    return sendGameStateTo(state, corrections, -1);
+}
+
+bool NetworkManager::sendGameStateToRoom(int roomId, const GameState& state, const std::vector<int>& corrections)
+{
+    return sendGameStateTo(state, corrections, roomId);
+}
+
+bool NetworkManager::sendGameStateTo(const GameState& state, const std::vector<int>& corrections, int roomId)
+{
+    if (!a) return false;
 
     try {
+        // Serialize before taking the socket lock so receiving isn't held up by it
         sf::Packet packet;
-        packet << static_cast<uint32_t>(static_cast<int>(MessageType::GAME_STATE)) << state;
+        sf::Packet correctedPacket;
+        {
+            ProfileScope profile(ProfilePhase::SERIALIZE);
+            packet << static_cast<uint32_t>(static_cast<int>(MessageType::GAME_STATE)) << state;
+
+            // Corrections ride along with the snapshot as a trailing flag, so the state
+            // is serialized once and corrected clients just get a second copy of it
+            if (!corrections.empty()) {
+                correctedPacket = packet;
+                correctedPacket << true;
+            }
+            packet << false;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(v);
+        if (!f) return false;
 
         bool allSucceeded = true;
 
-        for (auto client : b) {
+        for (size_t i = 0; i < b.size(); i++) {
+            sf::TcpSocket* client = b[i];
             if (!client) continue;
 
-            sf::Socket::Status status = client->send(packet);
-            if (status != sf::Socket::Status::Done) {
+            int clientId = w[i];
+
+            // In multi-room hosting a room only sends to its own connections
+            if (roomId >= 0) {
+                auto room = y.find(clientId);
+                if (room == y.end() || room->second != roomId) continue;
+            }
+
+            bool corrected = !corrections.empty() &&
+                std::find(corrections.begin(), corrections.end(), clientId) != corrections.end();
+
+            sf::Packet& outgoing = corrected ? correctedPacket : packet;
+            sf::Socket::Status status;
+            {
+                ProfileScope profile(ProfilePhase::SOCKET_SEND);
+                status = client->send(outgoing);
+            }
+            if (!recordSend(i, outgoing, status)) {
                 allSucceeded = false;
-                j++;
             }
         }
 
         return allSucceeded;
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in sendGameState: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "sendGameState", "error", ex.what());
+        return false;
+    }
+}
+
+void NetworkManager::forgetClient(int clientId)
+{
+    y.erase(clientId);
+}
+
+void NetworkManager::dropClient(int clientId)
+{
+    std::lock_guard<std::recursive_mutex> lock(v);
+
+    auto slot = std::find(w.begin(), w.end(), clientId);
+    if (slot == w.end()) return;
+
+    size_t index = static_cast<size_t>(slot - w.begin());
+    if (b[index]) {
+        KLOG_INFO(NET, "client_dropped", "client", clientId);
+        b[index]->disconnect();
+        delete b[index];
+        b[index] = nullptr;
+    }
+    forgetClient(clientId);
+}
+
+bool NetworkManager::recordSend(size_t slot, const sf::Packet& packet, sf::Socket::Status status)
+{
+    if (status != sf::Socket::Status::Done) {
+        aa[slot].sendFailures++;
+        j++;
+        return false;
+    }
+
+    uint64_t sent = packet.getDataSize() + sizeof(uint32_t);
+    aa[slot].bytesSent += sent;
+    ServerMetrics::global().bytesSent.fetch_add(sent, std::memory_order_relaxed);
+    return true;
+}
+
+void NetworkManager::getClientTraffic(std::vector<ClientTraffic>& out)
+{
+    std::lock_guard<std::recursive_mutex> lock(v);
+    out.clear();
+    for (size_t index = 0; index < b.size(); index++) {
+        if (b[index]) {
+            out.push_back(aa[index]);
+        }
+    }
+}
+
+void NetworkManager::setClientRoom(int clientId, int roomId)
+{
+    std::lock_guard<std::recursive_mutex> lock(v);
+    y[clientId] = roomId;
+
+    auto slot = std::find(w.begin(), w.end(), clientId);
+    if (slot == w.end() || !b[slot - w.begin()]) return;
+
+    size_t index = static_cast<size_t>(slot - w.begin());
+    sf::Packet packet;
+    packet << static_cast<uint32_t>(static_cast<int>(MessageType::ROOM_JOINED)) << static_cast<uint32_t>(roomId);
+    recordSend(index, packet, b[index]->send(packet));
+}
+
+int NetworkManager::getClientRoom(int clientId)
+{
+    std::lock_guard<std::recursive_mutex> lock(v);
+    auto room = y.find(clientId);
+    return room != y.end() ? room->second : -1;
+}
+
+bool NetworkManager::sendJoinRoom(int roomId)
+{
+    if (a || !f) return false;
+
+    try {
+        sf::Packet packet;
+        packet << static_cast<uint32_t>(static_cast<int>(MessageType::JOIN_ROOM)) << static_cast<uint32_t>(roomId);
+
+        if (c.send(packet) != sf::Socket::Status::Done) {
+            j++;
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception& ex) {
+        KLOG_ERROR(NET, "exception", "where", "sendJoinRoom", "error", ex.what());
         return false;
     }
 }
@@ -658,7 +837,7 @@ bool NetworkManager::sendPlayerInput(const PlayerInput& input)
         return true;
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in sendPlayerInput: " << ex.what() << std::endl;
+        KLOG_ERROR(NET, "exception", "where", "sendPlayerInput", "error", ex.what());
         return false;
     }
 }
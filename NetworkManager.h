@@ -34,13 +34,28 @@ enum class MessageType {
     HEARTBEAT = 4,
     DISCONNECT = 5,
     CLIENT_SIMULATION = 6,   // New message type for client simulation state
-    SERVER_VALIDATION = 7    // New message type for server validation
+    SERVER_VALIDATION = 7,   // New message type for server validation
+    JOIN_ROOM = 8,           // Lobby: client asks to be moved to a room (uint32 roomId)
+    ROOM_JOINED = 9          // Lobby: room the connection is now routed to (uint32 roomId)
+};
+
+// Traffic on one server connection since it was accepted. Byte counts
+// include SFML's 4-byte packet length prefix.
+struct ClientTraffic {
+    int clientId;
+    uint64_t bytesReceived;
+    uint64_t bytesSent;
+    uint64_t sendFailures;
 };
 
 class NetworkManager {
 private:
     bool a; // isHost
     std::vector<sf::TcpSocket*> b; // clients
+    std::vector<int> w; // clientIds - stable ID of the connection in the same slot of b
+    std::vector<ClientTraffic> aa; // clientTraffic - counters of the connection in the same slot of b
+    int x; // nextClientId
+    std::map<int, int> y; // clientRooms - room each connection is routed to (multi-room hosting)
     sf::TcpSocket c; // serverConnection
     sf::TcpListener d; // listener
     unsigned short e; // port
@@ -57,7 +72,7 @@ private:
 
     // Network diagnostics
     sf::Clock i; // lastPacketTime
-    int j; // packetLossCounter
+    std::atomic<int> j; // packetLossCounter
     int k; // pingMs
 
     // Connection state tracking
@@ -68,10 +83,20 @@ private:
     sf::Clock n; // syncClock - tracks time since last sync
     std::map<int, float> o; // clientLastSyncTimes - when each client last sent their simulation
 
+    // Snapshots may be sent from the broadcast worker while update() runs on the main thread
+    std::recursive_mutex v; // socketMutex - guards the client sockets (b) and connection state
+
     // Callbacks
     std::function<void(int clientId, const PlayerInput&)> s; // playerInputCallback
     std::function<void(int clientId)> t; // clientDisconnectedCallback
     std::function<void(int clientId, const std::string&)> u; // clientAuthenticatedCallback
+    std::function<void(int clientId, int roomId)> z; // joinRoomCallback
+
+    // Send one snapshot to every connection, or only to those routed to roomId
+    bool sendGameStateTo(const GameState& state, const std::vector<int>& corrections, int roomId);
+    void forgetClient(int clientId);
+    // Count a send to the connection in slot; failures also go to the packet loss counter
+    bool recordSend(size_t slot, const sf::Packet& packet, sf::Socket::Status status);
 
 public:
     NetworkManager(ClientManager& clientManager, ServerLogger& logger, ServerConfig& config);
@@ -85,18 +110,28 @@ public:
     bool joinGame(const sf::IpAddress& address, unsigned short port);
     void disconnect();
     void update();
-    bool sendGameState(const GameState& state);   // Host only
+    bool sendGameState(const GameState& state, const std::vector<int>& corrections = std::vector<int>());   // Host only
+    bool sendGameStateToRoom(int roomId, const GameState& state, const std::vector<int>& corrections);   // Host only
     bool sendPlayerInput(const PlayerInput& input); // Client only
 
     // New methods for distributed simulation
     bool sendClientSimulation(const GameState& clientState);  // Client sending its simulation
     bool sendServerValidation(const GameState& validatedState, int clientId);  // Server validation
 
+    // Lobby routing
+    void setClientRoom(int clientId, int roomId);   // Host: route a connection and tell the client
+    int getClientRoom(int clientId);                // Host: -1 if not routed
+    void dropClient(int clientId);                  // Host: close a connection that was never routed, e.g. when every room is full
+    bool sendJoinRoom(int roomId);                  // Client: ask to be moved to a room
+
     // Network robustness improvements
     void enableRobustNetworking();
     float getPing() const;
     int getPacketLoss() const;
 
+    // Host: copy every open connection's traffic counters into out (reuses its storage)
+    void getClientTraffic(std::vector<ClientTraffic>& out);
+
     // Sync interval setter/getter
     void setSyncInterval(float interval) { m = interval; }
     float getSyncInterval() const { return m; }
@@ -110,11 +145,13 @@ public:
     std::function<void(const GameState&)> onGameStateReceived;
     std::function<void(int clientId, const GameState&)> onClientSimulationReceived;  // New callback
     std::function<void(const GameState&)> onServerValidationReceived;  // New callback
+    std::function<void(int roomId)> onRoomJoined;  // Client: the server routed us to a room
 
     // New callback methods
     void setPlayerInputCallback(std::function<void(int clientId, const PlayerInput&)> callback) { s = callback; }
     void setClientDisconnectedCallback(std::function<void(int clientId)> callback) { t = callback; }
     void setClientAuthenticatedCallback(std::function<void(int clientId, const std::string&)> callback) { u = callback; }
+    void setJoinRoomCallback(std::function<void(int clientId, int roomId)> callback) { z = callback; }
 
     // Start/stop methods
     bool start();
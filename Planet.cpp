@@ -1,6 +1,7 @@
 // Planet.cpp
 #include "Planet.h"
 #include "GameConstants.h"
+#include "DeterministicMath.h"
 #include <cmath>
 Planet::Planet(sf::Vector2f pos, float radius, float mass, sf::Color color)
     : GameObject(pos, { 0, 0 }, color), // Pass color to GameObject constructor
@@ -47,7 +48,7 @@ void Planet::updateRadiusFromMass()
 {
     // Use cube root relationship between mass and radius
     radius = GameConstants::BASE_RADIUS_FACTOR *
-        std::pow(mass / GameConstants::REFERENCE_MASS, 1.0f / 3.0f);
+        DeterministicMath::cubeRoot(mass / GameConstants::REFERENCE_MASS);
 }
 
 sf::Color Planet::getColor() const
@@ -0,0 +1,123 @@
+// PlanetIndex.cpp
+#include "PlanetIndex.h"
+#include <cmath>
+#include <algorithm>
+
+PlanetIndex::PlanetIndex()
+    : b(GameConstants::PLANET_INDEX_BUCKETS + 1, 0), d(0.0f)
+{
+}
+
+int32_t PlanetIndex::cellOf(float coordinate)
+{
+    return static_cast<int32_t>(std::floor(coordinate / GameConstants::PLANET_INDEX_CELL_SIZE));
+}
+
+size_t PlanetIndex::bucketOf(int32_t cellX, int32_t cellY)
+{
+    uint32_t hash = (static_cast<uint32_t>(cellX) * 73856093u) ^ (static_cast<uint32_t>(cellY) * 19349663u);
+    return hash & (GameConstants::PLANET_INDEX_BUCKETS - 1);
+}
+
+void PlanetIndex::rebuild(const std::vector<Planet*>& planetList)
+{
+    c.clear();
+    d = 0.0f;
+    for (Planet* planet : planetList) {
+        if (!planet) continue;
+        c.push_back(planet);
+        d = std::max(d, planet->getRadius());
+    }
+
+    // Counting sort by bucket: count each bucket, turn the counts into start
+    // offsets, then place every entry at its bucket's next free slot
+    std::fill(b.begin(), b.end(), 0);
+    for (const Planet* planet : c) {
+        sf::Vector2f position = planet->getPosition();
+        b[bucketOf(cellOf(position.x), cellOf(position.y)) + 1]++;
+    }
+    for (size_t bucket = 1; bucket < b.size(); bucket++) {
+        b[bucket] += b[bucket - 1];
+    }
+
+    a.resize(c.size());
+    for (Planet* planet : c) {
+        Entry entry;
+        entry.a = planet;
+        entry.b = planet->getPosition();
+        entry.c = planet->getRadius();
+        entry.d = cellOf(entry.b.x);
+        entry.e = cellOf(entry.b.y);
+        a[b[bucketOf(entry.d, entry.e)]++] = entry;
+    }
+
+    // Placing advanced each start to its bucket's end; shift them back
+    for (size_t bucket = b.size() - 1; bucket > 0; bucket--) {
+        b[bucket] = b[bucket - 1];
+    }
+    b[0] = 0;
+}
+
+template<typename Visit>
+void PlanetIndex::forEachWithin(sf::Vector2f point, float reach, Visit&& visit) const
+{
+    // A planet can only be in reach if its center is within reach plus the
+    // largest radius, which bounds the cells to look in
+    float search = reach + d;
+    auto inReach = [&point, reach](const Entry& entry) {
+        sf::Vector2f offset = entry.b - point;
+        float limit = reach + entry.c;
+        return offset.x * offset.x + offset.y * offset.y <= limit * limit;
+    };
+
+    float span = 2.0f * search / GameConstants::PLANET_INDEX_CELL_SIZE + 2.0f;
+    if (span * span >= static_cast<float>(a.size())) {
+        // More cells than planets: checking them all is cheaper
+        for (const Entry& entry : a) {
+            if (inReach(entry)) visit(entry);
+        }
+        return;
+    }
+
+    int32_t minX = cellOf(point.x - search);
+    int32_t maxX = cellOf(point.x + search);
+    int32_t minY = cellOf(point.y - search);
+    int32_t maxY = cellOf(point.y + search);
+
+    for (int32_t cellY = minY; cellY <= maxY; cellY++) {
+        for (int32_t cellX = minX; cellX <= maxX; cellX++) {
+            size_t bucket = bucketOf(cellX, cellY);
+            for (uint32_t index = b[bucket]; index < b[bucket + 1]; index++) {
+                const Entry& entry = a[index];
+
+                // Other cells share the bucket; each entry is visited from its own cell only
+                if (entry.d != cellX || entry.e != cellY) continue;
+                if (inReach(entry)) visit(entry);
+            }
+        }
+    }
+}
+
+void PlanetIndex::queryRadius(sf::Vector2f point, float reach, std::vector<Planet*>& out) const
+{
+    forEachWithin(point, reach, [&out](const Entry& entry) {
+        out.push_back(entry.a);
+        });
+}
+
+Planet* PlanetIndex::nearest(sf::Vector2f point, float maxReach) const
+{
+    Planet* closest = nullptr;
+    float closestSurface = 0.0f;
+
+    forEachWithin(point, maxReach, [&point, &closest, &closestSurface](const Entry& entry) {
+        sf::Vector2f offset = entry.b - point;
+        float surface = std::sqrt(offset.x * offset.x + offset.y * offset.y) - entry.c;
+        if (!closest || surface < closestSurface) {
+            closest = entry.a;
+            closestSurface = surface;
+        }
+        });
+
+    return closest;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+// PlanetIndex.h
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <SFML/System/Vector2.hpp>
+#include "Planet.h"
+#include "GameConstants.h"
+
+// Spatial hash over the planets for "which planets are near this point"
+// questions from vehicles. Space is cut into square cells; each planet goes
+// in the cell holding its center, and cells are hashed into a fixed bucket
+// table, so the world has no bounds and rebuilding never allocates once the
+// entry array has grown to the planet count.
+//
+// The owner rebuilds it once per tick after the planets move. Queries only
+// read, so every player job can query it at once.
+class PlanetIndex {
+private:
+    struct Entry {
+        Planet* a; // planet
+        sf::Vector2f b; // position
+        float c; // radius
+        int32_t d; // cellX
+        int32_t e; // cellY
+    };
+
+    std::vector<Entry> a; // entries - grouped by bucket
+    std::vector<uint32_t> b; // bucketStart - first entry of each bucket, plus an end marker
+    std::vector<Planet*> c; // planets - every planet, in the order given to rebuild
+    float d; // maxRadius - largest planet; widens the cells a query visits
+
+    static int32_t cellOf(float coordinate);
+    static size_t bucketOf(int32_t cellX, int32_t cellY);
+
+    // Call visit(entry) for every planet whose surface is within reach of point
+    template<typename Visit>
+    void forEachWithin(sf::Vector2f point, float reach, Visit&& visit) const;
+
+public:
+    PlanetIndex();
+
+    // Index the planets at their current positions; null entries are skipped
+    void rebuild(const std::vector<Planet*>& planetList);
+
+    // Append to out every planet whose surface is within reach of point
+    // (a planet containing the point counts)
+    void queryRadius(sf::Vector2f point, float reach, std::vector<Planet*>& out) const;
+
+    // Planet whose surface is closest to point, if any is within maxReach
+    Planet* nearest(sf::Vector2f point, float maxReach) const;
+
+    const std::vector<Planet*>& getPlanets() const { return c; }
+    size_t size() const { return c.size(); }
+};
\ No newline at end of file
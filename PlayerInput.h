@@ -15,11 +15,12 @@ struct PlayerInput {
     float i; // clientTimestamp - when the client generated this input
     float j; // lastServerStateTimestamp - the timestamp of the last state client had
     RocketState k; // clientRocketState - current client rocket state for validation
+    unsigned int l; // inputSequence - increasing per input, echoed back by the server once applied
 
     // Default constructor
     PlayerInput() : a(0), b(false), c(false),
         d(false), e(false), f(false),
-        g(0.0f), h(0.0f), i(0.0f), j(0.0f) {
+        g(0.0f), h(0.0f), i(0.0f), j(0.0f), l(0) {
     }
 
     // Packet operators for serialization
@@ -34,14 +35,19 @@ inline sf::Packet& operator <<(sf::Packet& packet, const PlayerInput& input) {
         << input.d << input.e
         << input.f << input.g
         << input.h << input.i
-        << input.j << input.k;
+        << input.j << input.k
+        << static_cast<uint32_t>(input.l);
 }
 
 inline sf::Packet& operator >>(sf::Packet& packet, PlayerInput& input) {
-    return packet >> input.a
+    uint32_t inputSeq = 0;
+    packet >> input.a
         >> input.b >> input.c
         >> input.d >> input.e
         >> input.f >> input.g
         >> input.h >> input.i
-        >> input.j >> input.k;
+        >> input.j >> input.k
+        >> inputSeq;
+    input.l = inputSeq;
+    return packet;
 }
\ No newline at end of file
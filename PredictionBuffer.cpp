@@ -0,0 +1,74 @@
+// PredictionBuffer.cpp
+#include "PredictionBuffer.h"
+#include <algorithm>
+
+PredictionBuffer::PredictionBuffer(size_t capacity)
+    : a(std::max<size_t>(capacity, 2)), b(0), c(0), d(1), e(), f(false),
+    g(0.0f), h(0.0f), i(0.0), j(0), k(0)
+{
+}
+
+void PredictionBuffer::stageInput(const PlayerInput& input)
+{
+    e = input;
+    f = true;
+
+    // Keep our counter ahead of whatever sequence the caller used
+    if (!sequenceAfter(d, input.l)) {
+        d = input.l + 1;
+    }
+}
+
+void PredictionBuffer::pushFrame(float deltaTime, const RocketState& predicted)
+{
+    // Full ring - forget the oldest frame, the next correction will be larger
+    if (c == a.size()) {
+        b = (b + 1) % a.size();
+        c--;
+        k++;
+    }
+
+    PredictionFrame& frame = a[(b + c) % a.size()];
+    frame.b = f;
+    if (f) {
+        frame.a = e;
+    }
+    frame.c = deltaTime;
+    frame.d = predicted;
+    c++;
+
+    f = false;
+}
+
+void PredictionBuffer::acknowledge(unsigned int sequence)
+{
+    if (sequence == 0) return;
+
+    // Find the newest frame whose input the server has applied
+    size_t drop = 0;
+    for (size_t index = 0; index < c; index++) {
+        const PredictionFrame& frame = at(index);
+        if (!frame.b) continue;
+
+        if (sequenceAfter(frame.a.l, sequence)) break;
+        drop = index + 1;
+    }
+
+    b = (b + drop) % a.size();
+    c -= drop;
+}
+
+void PredictionBuffer::recordCorrection(float magnitude)
+{
+    g = magnitude;
+    h = std::max(h, magnitude);
+    i += magnitude;
+    j++;
+}
+
+void PredictionBuffer::clear()
+{
+    b = 0;
+    c = 0;
+    f = false;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+// PredictionBuffer.h
+#pragma once
+#include "PlayerInput.h"
+#include "GameState.h"
+#include <vector>
+#include <cstddef>
+
+// One locally simulated frame that the server hasn't confirmed yet
+struct PredictionFrame {
+    PlayerInput a; // input - applied at the start of the frame (if b is set)
+    bool b; // hasInput
+    float c; // deltaTime - time integrated after the input
+    RocketState d; // predictedState - local rocket state at the end of the frame
+};
+
+// Ring of unacknowledged inputs and the states they were predicted to produce.
+// When an authoritative state arrives the client rewinds to it and replays
+// the frames still in here.
+class PredictionBuffer {
+private:
+    std::vector<PredictionFrame> a; // frames - preallocated ring
+    size_t b; // start - index of the oldest pending frame
+    size_t c; // count - number of pending frames
+    unsigned int d; // nextSequence - sequence number for the next input (0 means none)
+    PlayerInput e; // stagedInput - applied this frame but not yet stepped
+    bool f; // hasStagedInput
+
+    // Correction statistics
+    float g; // lastCorrection - position error removed by the most recent reconcile
+    float h; // maxCorrection
+    double i; // totalCorrection
+    unsigned long j; // reconcileCount
+    unsigned long k; // overflowCount - frames dropped because the ring was full
+
+    static bool sequenceAfter(unsigned int lhs, unsigned int rhs) {
+        return static_cast<int>(lhs - rhs) > 0;
+    }
+
+public:
+    explicit PredictionBuffer(size_t capacity = 256);
+
+    // Sequence number the next staged input should carry
+    unsigned int peekSequence() const { return d; }
+
+    // Remember an input that has just been applied locally
+    void stageInput(const PlayerInput& input);
+    bool hasStagedInput() const { return f; }
+    const PlayerInput& getStagedInput() const { return e; }
+
+    // Close the current frame: store the staged input (if any), the step size and the result
+    void pushFrame(float deltaTime, const RocketState& predicted);
+
+    // Drop every frame up to and including the one carrying the given input
+    void acknowledge(unsigned int sequence);
+
+    size_t size() const { return c; }
+    size_t capacity() const { return a.size(); }
+    PredictionFrame& at(size_t index) { return a[(b + index) % a.size()]; }
+    const PredictionFrame& at(size_t index) const { return a[(b + index) % a.size()]; }
+
+    void recordCorrection(float magnitude);
+    float getLastCorrection() const { return g; }
+    float getMaxCorrection() const { return h; }
+    float getAverageCorrection() const { return j ? static_cast<float>(i / j) : 0.0f; }
+    unsigned long getReconcileCount() const { return j; }
+    unsigned long getOverflowCount() const { return k; }
+
+    void clear();
+};
\ No newline at end of file
@@ -0,0 +1,149 @@
+// ReplayLog.cpp
+#include "ReplayLog.h"
+#include <cstring>
+
+namespace {
+    const char MAGIC[4] = { 'K', 'R', 'P', 'L' };
+
+    void appendRaw(std::vector<char>& out, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+}
+
+ReplayWriter::ReplayWriter()
+    : d(0), e(false)
+{
+}
+
+ReplayWriter::~ReplayWriter()
+{
+    close();
+}
+
+bool ReplayWriter::open(const std::string& path, float tickSeconds)
+{
+    close();
+
+    a.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!a.is_open()) return false;
+
+    b.clear();
+    b.reserve(FLUSH_BYTES + 64 * 1024);
+    d = 0;
+    e = false;
+
+    uint32_t version = VERSION;
+    appendRaw(b, MAGIC, sizeof(MAGIC));
+    appendRaw(b, &version, sizeof(version));
+    appendRaw(b, &tickSeconds, sizeof(tickSeconds));
+    return true;
+}
+
+void ReplayWriter::close()
+{
+    if (!a.is_open()) return;
+
+    flushBuffer();
+    a.close();
+}
+
+void ReplayWriter::append(ReplayRecordType type, const sf::Packet& payload)
+{
+    if (!a.is_open() || e) return;
+
+    uint8_t typeByte = static_cast<uint8_t>(type);
+    uint32_t length = static_cast<uint32_t>(payload.getDataSize());
+    appendRaw(b, &typeByte, sizeof(typeByte));
+    appendRaw(b, &length, sizeof(length));
+    appendRaw(b, payload.getData(), length);
+    d++;
+
+    if (b.size() >= FLUSH_BYTES) {
+        flushBuffer();
+    }
+}
+
+void ReplayWriter::flushBuffer()
+{
+    if (b.empty()) return;
+
+    a.write(b.data(), static_cast<std::streamsize>(b.size()));
+    if (!a.good()) {
+        // Disk full or similar: stop recording rather than write a torn log
+        e = true;
+    }
+    b.clear();
+}
+
+void ReplayWriter::recordTick(float deltaTime)
+{
+    c.clear();
+    c << deltaTime;
+    append(ReplayRecordType::TICK, c);
+}
+
+void ReplayWriter::recordConnect(int clientId, sf::Vector2f spawnPosition)
+{
+    c.clear();
+    c << static_cast<int32_t>(clientId) << spawnPosition;
+    append(ReplayRecordType::CONNECT, c);
+}
+
+void ReplayWriter::recordDisconnect(int clientId)
+{
+    c.clear();
+    c << static_cast<int32_t>(clientId);
+    append(ReplayRecordType::DISCONNECT, c);
+}
+
+void ReplayWriter::recordInput(int clientId, const PlayerInput& input)
+{
+    c.clear();
+    c << static_cast<int32_t>(clientId) << input;
+    append(ReplayRecordType::INPUT, c);
+}
+
+void ReplayWriter::recordKeyframe(const GameState& state)
+{
+    c.clear();
+    c << state;
+    append(ReplayRecordType::KEYFRAME, c);
+}
+
+ReplayReader::ReplayReader()
+    : c(0.0f)
+{
+}
+
+bool ReplayReader::open(const std::string& path)
+{
+    a.open(path, std::ios::in | std::ios::binary);
+    if (!a.is_open()) return false;
+
+    char magic[4];
+    uint32_t version = 0;
+    a.read(magic, sizeof(magic));
+    a.read(reinterpret_cast<char*>(&version), sizeof(version));
+    a.read(reinterpret_cast<char*>(&c), sizeof(c));
+
+    return a.good() && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && version == ReplayWriter::VERSION;
+}
+
+bool ReplayReader::next(ReplayRecordType& type, sf::Packet& payload)
+{
+    uint8_t typeByte = 0;
+    uint32_t length = 0;
+    a.read(reinterpret_cast<char*>(&typeByte), sizeof(typeByte));
+    a.read(reinterpret_cast<char*>(&length), sizeof(length));
+    if (!a.good()) return false;
+
+    b.resize(length);
+    a.read(b.data(), length);
+    if (static_cast<uint32_t>(a.gcount()) != length) return false;
+
+    type = static_cast<ReplayRecordType>(typeByte);
+    payload.clear();
+    payload.append(b.data(), b.size());
+    return true;
+}
\ No newline at end of file
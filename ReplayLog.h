@@ -0,0 +1,81 @@
+// ReplayLog.h
+#pragma once
+#include <SFML/Network.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "GameState.h"
+#include "PlayerInput.h"
+
+// Everything a replay needs to re-drive a GameServer: the tick boundaries,
+// who joined and left, every accepted input, and keyframe snapshots to check
+// the re-simulation against.
+//
+// File layout: "KRPL", uint32 version, float tick seconds, then records of
+// uint8 type, uint32 payload length and the payload. Payloads use the same
+// sf::Packet encoding as the wire protocol.
+enum class ReplayRecordType : uint8_t {
+    TICK = 1,           // float deltaTime - one GameServer::update
+    CONNECT = 2,        // int clientId, Vector2f spawn position
+    DISCONNECT = 3,     // int clientId
+    INPUT = 4,          // int clientId, PlayerInput
+    KEYFRAME = 5        // GameState after the preceding tick
+};
+
+// Appends records to a replay file through an in-memory buffer that is
+// written out in large sequential chunks. Recording a record reuses the same
+// scratch packet and buffer, so after warm-up it doesn't allocate.
+class ReplayWriter {
+public:
+    static constexpr uint32_t VERSION = 2;     // 2: keyframes carry the state hash
+    static constexpr size_t FLUSH_BYTES = 256 * 1024;
+
+private:
+    std::ofstream a; // file
+    std::vector<char> b; // buffer - records not yet written out
+    sf::Packet c; // scratch - reused to encode each payload
+    unsigned long d; // recordCount
+    bool e; // failed - a write failed; nothing more is recorded
+
+    void append(ReplayRecordType type, const sf::Packet& payload);
+    void flushBuffer();
+
+public:
+    ReplayWriter();
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const std::string& path, float tickSeconds);
+    void close();
+    bool isOpen() const { return a.is_open(); }
+    unsigned long getRecordCount() const { return d; }
+
+    void recordTick(float deltaTime);
+    void recordConnect(int clientId, sf::Vector2f spawnPosition);
+    void recordDisconnect(int clientId);
+    void recordInput(int clientId, const PlayerInput& input);
+    void recordKeyframe(const GameState& state);
+};
+
+// Reads a replay file record by record
+class ReplayReader {
+private:
+    std::ifstream a; // file
+    std::vector<char> b; // bytes - payload of the current record
+    float c; // tickSeconds
+
+public:
+    ReplayReader();
+
+    // False if the file is missing or isn't a replay of a version we read
+    bool open(const std::string& path);
+
+    float getTickSeconds() const { return c; }
+
+    // Next record's type and payload; false at the end of the file (or at a
+    // truncated last record, as left by a crash)
+    bool next(ReplayRecordType& type, sf::Packet& payload);
+};
\ No newline at end of file
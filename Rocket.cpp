@@ -2,12 +2,13 @@
 #include "Rocket.h"
 #include "VectorHelper.h"
 #include "GameConstants.h"
+#include "DeterministicMath.h"
 #include <cmath>
 #include <iostream>
 
 Rocket::Rocket(sf::Vector2f pos, sf::Vector2f vel, int playerId, float mass, sf::Color color)
     : GameObject(pos, vel, color), a(0), b(0), c(0.0f), d(mass), e(color),
-    f(playerId), g(0.0f), h(), i(true), j(0.0f), k(GameConstants::BASE_FUEL_CONSUMPTION_RATE)
+    f(playerId), g(0.0f), h(nullptr), i(true), j(0.0f), k(GameConstants::BASE_FUEL_CONSUMPTION_RATE)
 {
     // Constructor implementation
 }
@@ -16,7 +17,7 @@ void Rocket::applyThrust(float amount)
 {
     // Calculate thrust direction based on rocket rotation
     float p = a * 3.14159f / 180.0f;
-    sf::Vector2f q(std::sin(p), -std::cos(p));
+    sf::Vector2f q(DeterministicMath::sine(p), -DeterministicMath::cosine(p));
 
     // Apply force with thrust multiplication
     velocity += q * amount * c * 1.0f / d;
@@ -35,8 +36,36 @@ void Rocket::setThrustLevel(float level)
 
 void Rocket::update(float deltaTime)
 {
-    // Update position based on velocity
-    position += velocity * deltaTime;
+    // Move in straight segments, checking each against the nearby planets
+    // along its whole length so a fast rocket can't skip over a small planet
+    // between ticks. The first surface crossed stops the segment there; the
+    // rocket slides off it and spends the rest of the step in the next one.
+    // Planets are treated as still while the rocket moves
+    float remaining = deltaTime;
+    for (int substep = 0; substep < GameConstants::ROCKET_COLLISION_SUBSTEPS && remaining > 0.0f; substep++) {
+        sf::Vector2f motion = velocity * remaining;
+
+        const Planet* hit = nullptr;
+        float hitTime = 1.0f;
+        if (h) {
+            for (const Planet* planet : *h) {
+                float time;
+                if (timeOfImpact(*planet, motion, time) && (!hit || time < hitTime)) {
+                    hit = planet;
+                    hitTime = time;
+                }
+            }
+        }
+
+        if (!hit) {
+            position += motion;
+            break;
+        }
+
+        position += motion * hitTime;
+        resolvePlanetContact(*hit);
+        remaining -= remaining * hitTime;
+    }
 
     // Update rotation based on angular velocity
     a += b * deltaTime;
@@ -44,27 +73,15 @@ void Rocket::update(float deltaTime)
     // Apply damping to angular velocity
     b *= 0.98f;
 
-    // Update timestamp
-    g = static_cast<float>(std::time(nullptr));
+    // Advance the state timestamp in simulation time, never wall-clock time,
+    // so the same inputs always produce the same state
+    g += deltaTime;
 }
 
-void Rocket::setNearbyPlanets(const std::vector<Planet*>& planets)
+const std::vector<Planet*>& Rocket::getNearbyPlanets() const
 {
-    try {
-        // Clear existing planets
-        h.clear();
-
-        // Only add non-null planets
-        for (auto* planet : planets) {
-            if (planet) {
-                h.push_back(planet);
-            }
-        }
-    }
-    catch (const std::exception& ex) {
-        std::cerr << "Exception in setNearbyPlanets: " << ex.what() << std::endl;
-        h.clear();
-    }
+    static const std::vector<Planet*> none;
+    return h ? *h : none;
 }
 
 bool Rocket::isColliding(const Planet& planet) const
@@ -73,6 +90,52 @@ bool Rocket::isColliding(const Planet& planet) const
     return dist < planet.getRadius() + GameConstants::ROCKET_SIZE;
 }
 
+bool Rocket::timeOfImpact(const Planet& planet, sf::Vector2f motion, float& time) const
+{
+    // Solve |offset + motion * t| = reach, i.e. a*t^2 + 2*b*t + c = 0, for the first t in [0, 1]
+    sf::Vector2f offset = position - planet.getPosition();
+    float reach = planet.getRadius() + GameConstants::ROCKET_SIZE;
+    float b = offset.x * motion.x + offset.y * motion.y;
+    float c = offset.x * offset.x + offset.y * offset.y - reach * reach;
+
+    if (c < 0.0f) {
+        time = 0.0f;
+        return true;
+    }
+
+    // Moving away from the planet or past it
+    if (b >= 0.0f) return false;
+
+    float a = motion.x * motion.x + motion.y * motion.y;
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) return false;
+
+    // b < 0 means a > 0, and c >= 0 keeps the nearer root at or after the start
+    float t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1.0f) return false;
+
+    time = t;
+    return true;
+}
+
+void Rocket::resolvePlanetContact(const Planet& planet)
+{
+    sf::Vector2f offset = position - planet.getPosition();
+    float dist = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+    sf::Vector2f normal = dist > 0.0f ? offset / dist : sf::Vector2f(0.0f, -1.0f);
+
+    // Leave a small gap so the next sweep starts clear of the surface
+    float rest = planet.getRadius() + GameConstants::ROCKET_SIZE + GameConstants::ROCKET_CONTACT_SKIN;
+    if (dist < rest) {
+        position = planet.getPosition() + normal * rest;
+    }
+
+    float into = velocity.x * normal.x + velocity.y * normal.y;
+    if (into < 0.0f) {
+        velocity -= normal * into;
+    }
+}
+
 void Rocket::addStoredMass(float amount)
 {
     j += amount;
@@ -84,9 +147,6 @@ void Rocket::addStoredMass(float amount)
 
     // Update total mass (base mass + stored mass)
     d = 1.0f + j;
-
-    // Update timestamp
-    g = static_cast<float>(std::time(nullptr));
 }
 
 RocketState Rocket::createState() const
@@ -16,8 +16,8 @@ private:
     float d; // mass
     sf::Color e; // color
     int f; // playerId/ownerId
-    float g; // lastStateTimestamp - when rocket state was last updated
-    std::vector<Planet*> h; // nearbyPlanets for collision detection
+    float g; // lastStateTimestamp - simulation time of the last update (server game time once synced)
+    const std::vector<Planet*>* h; // nearbyPlanets - list owned by the vehicle manager, for collision detection
     bool i; // hasFuel - tracking if rocket has fuel
     float j; // storedMass - amount of mass taken from planets
     float k; // fuelConsumptionRate - how fast fuel is used
@@ -31,9 +31,20 @@ public:
     void setThrustLevel(float level);
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
-    void setNearbyPlanets(const std::vector<Planet*>& planets);
+    // Point at a planet list without copying it; the list must outlive the
+    // rocket (or be replaced first) and must not contain nulls
+    void setNearbyPlanets(const std::vector<Planet*>& planets) { h = &planets; }
     bool isColliding(const Planet& planet) const;
 
+    // Swept test for moving by motion this update: the fraction of motion
+    // (0 to 1) at which the rocket first touches the planet's surface. A
+    // rocket already inside reports 0. False if it doesn't touch
+    bool timeOfImpact(const Planet& planet, sf::Vector2f motion, float& time) const;
+
+    // Stand on a planet being touched: lift out of it if inside, and drop the
+    // velocity into its surface while keeping any sliding along it
+    void resolvePlanetContact(const Planet& planet);
+
     // State methods
     RocketState createState() const;
     void applyState(const RocketState& state);
@@ -45,6 +56,8 @@ public:
     // Getters/setters
     float getRotation() const { return a; }
     void setRotation(float rot) { a = rot; }
+    float getAngularVelocity() const { return b; }
+    void setAngularVelocity(float angVel) { b = angVel; }
     float getThrustLevel() const { return c; }
     float getMass() const { return d; }
     void setMass(float newMass) { d = newMass; }
@@ -56,7 +69,7 @@ public:
     bool hasFuel() const { return i; }
     float getStoredMass() const { return j; }
     void addStoredMass(float amount);
-    const std::vector<Planet*>& getNearbyPlanets() const { return h; }
+    const std::vector<Planet*>& getNearbyPlanets() const;
     sf::Color getColor() const { return e; }
     void setColor(sf::Color newColor) { e = newColor; }
 };
\ No newline at end of file
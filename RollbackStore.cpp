@@ -0,0 +1,146 @@
+// RollbackStore.cpp
+#include "RollbackStore.h"
+#include <algorithm>
+#include <cstring>
+
+RollbackStore::RollbackStore(size_t capacity, size_t bytesPerSnapshot)
+    : d(std::max<size_t>(2, capacity)), e(0), f(0), h(0), i(0)
+{
+    // The pool holds every slot as a full copy, the case where nothing is shared
+    size_t chunksPerSnapshot = (bytesPerSnapshot + CHUNK_BYTES - 1) / CHUNK_BYTES;
+    size_t chunkCount = chunksPerSnapshot * d.size();
+
+    a.resize(chunkCount * CHUNK_BYTES);
+    b.assign(chunkCount, 0);
+    c.reserve(chunkCount);
+    for (size_t chunk = chunkCount; chunk > 0; chunk--) {
+        c.push_back(static_cast<uint32_t>(chunk - 1));
+    }
+
+    for (Slot& slot : d) {
+        slot.c.reserve(chunksPerSnapshot);
+    }
+    g.reserve(chunksPerSnapshot * CHUNK_BYTES);
+}
+
+std::vector<char>& RollbackStore::beginCapture()
+{
+    g.clear();
+    return g;
+}
+
+void RollbackStore::commit(uint64_t tick)
+{
+    size_t bytes = g.size();
+    size_t chunkCount = (bytes + CHUNK_BYTES - 1) / CHUNK_BYTES;
+
+    // Pad the last chunk so whole chunks can be compared
+    g.resize(chunkCount * CHUNK_BYTES, 0);
+
+    // Slots run oldest to newest around the ring; the one after the newest is
+    // free unless the ring is full, in which case it holds the oldest
+    size_t target = f > 0 ? (e + 1) % d.size() : 0;
+    if (d[target].d) {
+        releaseSlot(d[target]);
+        f--;
+    }
+    reserveChunks(chunkCount);
+
+    const Slot* previous = f > 0 ? &d[e] : nullptr;
+    Slot& slot = d[target];
+    slot.c.clear();
+
+    for (size_t index = 0; index < chunkCount; index++) {
+        const char* source = g.data() + index * CHUNK_BYTES;
+
+        if (previous && index < previous->c.size()) {
+            uint32_t candidate = previous->c[index];
+            if (std::memcmp(chunkData(candidate), source, CHUNK_BYTES) == 0) {
+                b[candidate]++;
+                slot.c.push_back(candidate);
+                h++;
+                continue;
+            }
+        }
+
+        uint32_t chunk = c.back();
+        c.pop_back();
+        std::memcpy(chunkData(chunk), source, CHUNK_BYTES);
+        b[chunk] = 1;
+        slot.c.push_back(chunk);
+        i++;
+    }
+
+    slot.a = tick;
+    slot.b = bytes;
+    slot.d = true;
+    e = target;
+    f++;
+}
+
+const std::vector<char>* RollbackStore::load(uint64_t tick)
+{
+    for (Slot& slot : d) {
+        if (!slot.d || slot.a != tick) continue;
+
+        g.resize(slot.c.size() * CHUNK_BYTES);
+        for (size_t index = 0; index < slot.c.size(); index++) {
+            std::memcpy(g.data() + index * CHUNK_BYTES, chunkData(slot.c[index]), CHUNK_BYTES);
+        }
+        g.resize(slot.b);
+        return &g;
+    }
+    return nullptr;
+}
+
+void RollbackStore::discardAfter(uint64_t tick)
+{
+    while (f > 0 && d[e].a > tick) {
+        releaseSlot(d[e]);
+        f--;
+        e = (e + d.size() - 1) % d.size();
+    }
+}
+
+void RollbackStore::clear()
+{
+    for (Slot& slot : d) {
+        if (slot.d) releaseSlot(slot);
+    }
+    e = 0;
+    f = 0;
+}
+
+bool RollbackStore::contains(uint64_t tick) const
+{
+    for (const Slot& slot : d) {
+        if (slot.d && slot.a == tick) return true;
+    }
+    return false;
+}
+
+void RollbackStore::releaseSlot(Slot& slot)
+{
+    for (uint32_t chunk : slot.c) {
+        if (--b[chunk] == 0) {
+            c.push_back(chunk);
+        }
+    }
+    slot.c.clear();
+    slot.d = false;
+}
+
+void RollbackStore::reserveChunks(size_t needed)
+{
+    if (c.size() >= needed) return;
+
+    // States grew past the estimate (more players or planets): grow the pool
+    // rather than drop history. Chunks are addressed by index, so this is safe
+    size_t oldCount = b.size();
+    size_t newCount = std::max(oldCount * 2, oldCount + needed);
+    a.resize(newCount * CHUNK_BYTES);
+    b.resize(newCount, 0);
+    for (size_t chunk = newCount; chunk > oldCount; chunk--) {
+        c.push_back(static_cast<uint32_t>(chunk - 1));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+// RollbackStore.h
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Ring of captured simulation states for rolling back and re-simulating.
+//
+// A state is written into one flat scratch buffer, then cut into fixed-size
+// chunks kept in a preallocated pool. A chunk whose bytes match the same
+// chunk of the previous capture isn't copied: both snapshots point at one
+// reference-counted copy, so fields that rarely change (masses, colors, ids -
+// callers lay those out together) cost nothing after the first capture.
+//
+// Not thread-safe; it belongs to the thread that steps the simulation.
+class RollbackStore {
+public:
+    static constexpr size_t CHUNK_BYTES = 256;
+
+private:
+    struct Slot {
+        uint64_t a = 0; // tick
+        size_t b = 0; // bytes - captured length before padding
+        std::vector<uint32_t> c; // chunks - indices into the pool
+        bool d = false; // used
+    };
+
+    std::vector<char> a; // pool - chunk storage, CHUNK_BYTES each
+    std::vector<uint32_t> b; // refCounts - per chunk
+    std::vector<uint32_t> c; // freeChunks
+    std::vector<Slot> d; // slots
+    size_t e; // newest - slot of the latest capture
+    size_t f; // count - slots in use
+    std::vector<char> g; // scratch - capture input and restore output
+
+    uint64_t h; // chunksShared
+    uint64_t i; // chunksCopied
+
+    void releaseSlot(Slot& slot);
+    void reserveChunks(size_t needed);
+    char* chunkData(uint32_t chunk) { return a.data() + static_cast<size_t>(chunk) * CHUNK_BYTES; }
+
+public:
+    // Room for capacity snapshots of about bytesPerSnapshot each, all allocated up front
+    RollbackStore(size_t capacity, size_t bytesPerSnapshot);
+
+    // Empty scratch buffer to write the next state into
+    std::vector<char>& beginCapture();
+
+    // Store the scratch buffer as the given tick, overwriting the oldest
+    // snapshot once the ring is full
+    void commit(uint64_t tick);
+
+    // Reassemble a stored tick; the returned buffer is valid until the next
+    // beginCapture or load. nullptr if the tick isn't held
+    const std::vector<char>* load(uint64_t tick);
+
+    // Drop every snapshot newer than tick, e.g. after rolling back to it
+    void discardAfter(uint64_t tick);
+    void clear();
+
+    bool contains(uint64_t tick) const;
+    size_t size() const { return f; }
+    size_t capacity() const { return d.size(); }
+    size_t getChunksInUse() const { return b.size() - c.size(); }
+    uint64_t getChunksShared() const { return h; }
+    uint64_t getChunksCopied() const { return i; }
+};
\ No newline at end of file
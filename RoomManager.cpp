@@ -0,0 +1,278 @@
+// RoomManager.cpp
+#include "RoomManager.h"
+#include "NetworkManager.h"
+#include "TickScheduler.h"
+#include "TraceRecorder.h"
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+RoomManager::RoomManager(NetworkManager& network, ServerLogger& logger, ServerConfig& config)
+    : a(network), b(logger), c(config), f(false)
+{
+}
+
+RoomManager::~RoomManager()
+{
+    stop();
+}
+
+void RoomManager::start()
+{
+    if (f) return;
+
+    int roomCount = std::max(1, c.getRoomCount());
+    for (int i = 0; i < roomCount; i++) {
+        d.push_back(std::make_unique<Room>(i, b, c));
+        d.back()->b.initialize();
+    }
+
+    // Everything below runs on the I/O thread, inside NetworkManager::update
+    a.setClientAuthenticatedCallback([this](int clientId, const std::string&) {
+        onClientConnected(clientId);
+        });
+
+    a.setClientDisconnectedCallback([this](int clientId) {
+        onClientDisconnected(clientId);
+        });
+
+    a.setJoinRoomCallback([this](int clientId, int roomId) {
+        onJoinRequest(clientId, roomId);
+        });
+
+    a.setPlayerInputCallback([this](int clientId, const PlayerInput& input) {
+        RoomEvent event;
+        event.a = RoomEventType::PLAYER_INPUT;
+        event.b = clientId;
+        event.c = input;
+        post(a.getClientRoom(clientId), std::move(event));
+        });
+
+    a.onClientSimulationReceived = [this](int clientId, const GameState& clientState) {
+        RoomEvent event;
+        event.a = RoomEventType::CLIENT_SIMULATION;
+        event.b = clientId;
+        event.d = clientState;
+        post(a.getClientRoom(clientId), std::move(event));
+        };
+
+    // One worker per spare core by default - the main thread keeps the I/O
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    int workerCount = c.getRoomWorkers();
+    if (workerCount <= 0) {
+        workerCount = static_cast<int>(cores > 1 ? cores - 1 : 1);
+    }
+    workerCount = std::min(workerCount, roomCount);
+
+    f = true;
+    for (int w = 0; w < workerCount; w++) {
+        std::vector<Room*> owned;
+        for (int r = w; r < roomCount; r += workerCount) {
+            owned.push_back(d[r].get());
+        }
+
+        e.emplace_back(&RoomManager::runWorker, this, w, owned);
+        pinToCore(e.back(), (static_cast<unsigned int>(w) + 1) % cores);
+    }
+
+    b.info("Hosting " + std::to_string(roomCount) + " rooms on " + std::to_string(workerCount) + " workers");
+}
+
+void RoomManager::stop()
+{
+    if (!f) return;
+
+    f = false;
+    for (auto& worker : e) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    e.clear();
+}
+
+void RoomManager::pinToCore(std::thread& thread, unsigned int core)
+{
+#if defined(_WIN32)
+    SetThreadAffinityMask(thread.native_handle(), static_cast<DWORD_PTR>(1) << core);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+void RoomManager::post(int roomId, RoomEvent&& event)
+{
+    if (roomId < 0 || roomId >= static_cast<int>(d.size())) return;
+
+    Room& room = *d[roomId];
+    std::lock_guard<std::mutex> lock(room.c);
+    room.d.push_back(std::move(event));
+}
+
+int RoomManager::leastLoadedRoom() const
+{
+    int best = 0;
+    for (size_t i = 1; i < d.size(); i++) {
+        if (d[i]->g < d[best]->g) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+void RoomManager::onClientConnected(int clientId)
+{
+    // The least loaded room being full means they all are
+    int roomId = leastLoadedRoom();
+    if (d[roomId]->g >= c.getMaxClients()) {
+        b.warning("All rooms are full, turning away client " + std::to_string(clientId));
+        a.dropClient(clientId);
+        return;
+    }
+
+    d[roomId]->g++;
+    a.setClientRoom(clientId, roomId);
+
+    RoomEvent event;
+    event.a = RoomEventType::PLAYER_JOINED;
+    event.b = clientId;
+    post(roomId, std::move(event));
+}
+
+void RoomManager::onClientDisconnected(int clientId)
+{
+    int roomId = a.getClientRoom(clientId);
+    if (roomId < 0) return;
+
+    d[roomId]->g--;
+
+    RoomEvent event;
+    event.a = RoomEventType::PLAYER_LEFT;
+    event.b = clientId;
+    post(roomId, std::move(event));
+}
+
+void RoomManager::onJoinRequest(int clientId, int roomId)
+{
+    int current = a.getClientRoom(clientId);
+
+    // Unknown or full rooms leave the connection where it is; the reply says where that is
+    if (roomId < 0 || roomId >= static_cast<int>(d.size()) || roomId == current ||
+        d[roomId]->g >= c.getMaxClients()) {
+        a.setClientRoom(clientId, current);
+        return;
+    }
+
+    if (current >= 0) {
+        d[current]->g--;
+
+        RoomEvent leave;
+        leave.a = RoomEventType::PLAYER_LEFT;
+        leave.b = clientId;
+        post(current, std::move(leave));
+    }
+
+    d[roomId]->g++;
+    a.setClientRoom(clientId, roomId);
+
+    RoomEvent join;
+    join.a = RoomEventType::PLAYER_JOINED;
+    join.b = clientId;
+    post(roomId, std::move(join));
+}
+
+void RoomManager::drainInbox(Room& room)
+{
+    {
+        std::lock_guard<std::mutex> lock(room.c);
+        std::swap(room.d, room.e);
+    }
+
+    for (RoomEvent& event : room.e) {
+        switch (event.a) {
+        case RoomEventType::PLAYER_JOINED:
+            room.b.addPlayer(event.b, room.b.getClientSpawnPosition(), sf::Color::Red);
+            break;
+        case RoomEventType::PLAYER_LEFT:
+            room.b.handlePlayerDisconnect(event.b);
+            break;
+        case RoomEventType::PLAYER_INPUT:
+            room.b.handlePlayerInput(event.b, event.c);
+            break;
+        case RoomEventType::CLIENT_SIMULATION:
+            room.b.processClientSimulation(event.b, event.d);
+            break;
+        }
+    }
+    room.e.clear();
+}
+
+void RoomManager::runWorker(int workerIndex, std::vector<Room*> ownedRooms)
+{
+    TraceRecorder::setThreadName("room worker");
+    TickScheduler scheduler(c.getUpdateRate(), c.getMaxCatchUpSteps());
+
+    scheduler.setReceivePhase([this, &ownedRooms]() {
+        for (Room* room : ownedRooms) {
+            drainInbox(*room);
+        }
+        });
+
+    scheduler.setSimulationPhase([&ownedRooms](float deltaTime) {
+        for (Room* room : ownedRooms) {
+            room->b.update(deltaTime);
+        }
+        });
+
+    scheduler.setBroadcastPhase([this, &ownedRooms]() {
+        for (Room* room : ownedRooms) {
+            GameState state = room->b.getGameState();
+            room->b.takeCorrections(room->f);
+            a.sendGameStateToRoom(room->a, state, room->f);
+        }
+        });
+
+    auto lastStatusTime = std::chrono::steady_clock::now();
+
+    while (f) {
+        scheduler.runFrame();
+
+        auto currentTime = std::chrono::steady_clock::now();
+        auto statusDuration = std::chrono::duration_cast<std::chrono::seconds>(currentTime - lastStatusTime).count();
+        if (statusDuration >= 10) {
+            b.info("Room worker " + std::to_string(workerIndex) + ":");
+            scheduler.logStats(b);
+            for (Room* room : ownedRooms) {
+                room->b.logValidationStats(static_cast<float>(statusDuration));
+            }
+            lastStatusTime = currentTime;
+        }
+    }
+}
+
+void RoomManager::logStats()
+{
+    std::stringstream ss;
+    ss << "Rooms:";
+    for (const auto& room : d) {
+        ss << " [" << room->a << "] " << room->g << " players";
+    }
+    b.info(ss.str());
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+// RoomManager.h
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "GameServer.h"
+#include "GameState.h"
+#include "PlayerInput.h"
+#include "ServerLogger.h"
+#include "ServerConfig.h"
+
+class NetworkManager;
+
+// Something the I/O thread hands to a room's worker
+enum class RoomEventType {
+    PLAYER_JOINED,
+    PLAYER_LEFT,
+    PLAYER_INPUT,
+    CLIENT_SIMULATION
+};
+
+struct RoomEvent {
+    RoomEventType a; // type
+    int b; // clientId
+    PlayerInput c; // input - for PLAYER_INPUT
+    GameState d; // simulation - for CLIENT_SIMULATION
+};
+
+// One independent game session. Only the worker that owns the room touches
+// its GameServer; the I/O thread talks to it through the inbox.
+struct Room {
+    int a; // id
+    GameServer b; // server
+    std::mutex c; // inboxMutex
+    std::vector<RoomEvent> d; // inbox - filled by the I/O thread
+    std::vector<RoomEvent> e; // processing - swapped out of the inbox by the worker
+    std::vector<int> f; // corrections - scratch for the players flagged each broadcast
+    std::atomic<int> g; // players - connections routed here, counted on the I/O thread
+
+    Room(int id, ServerLogger& logger, ServerConfig& config)
+        : a(id), b(logger, config), g(0) {}
+};
+
+// Hosts several GameServer instances in one process. Rooms are split across
+// a pool of worker threads, each pinned to its own core and ticking its rooms
+// with its own TickScheduler. Rooms share nothing but the NetworkManager:
+// the I/O thread routes each connection's messages to its room, and workers
+// send snapshots only to the connections routed to their rooms.
+//
+// New connections go to the room with the fewest players; a JOIN_ROOM lobby
+// message moves a connection to another room if it has space.
+class RoomManager {
+private:
+    NetworkManager& a; // network
+    ServerLogger& b; // logger
+    ServerConfig& c; // config
+
+    std::vector<std::unique_ptr<Room>> d; // rooms
+    std::vector<std::thread> e; // workers
+    std::atomic<bool> f; // running
+
+    void runWorker(int workerIndex, std::vector<Room*> ownedRooms);
+    void post(int roomId, RoomEvent&& event);
+    void drainInbox(Room& room);
+
+    // I/O thread side
+    void onClientConnected(int clientId);
+    void onClientDisconnected(int clientId);
+    void onJoinRequest(int clientId, int roomId);
+    int leastLoadedRoom() const;
+
+    static void pinToCore(std::thread& thread, unsigned int core);
+
+public:
+    RoomManager(NetworkManager& network, ServerLogger& logger, ServerConfig& config);
+    ~RoomManager();
+
+    // Create the rooms, hook the network callbacks and start the workers
+    void start();
+    void stop();
+
+    void logStats();
+
+    int getRoomCount() const { return static_cast<int>(d.size()); }
+    int getWorkerCount() const { return static_cast<int>(e.size()); }
+};
\ No newline at end of file
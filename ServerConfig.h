@@ -8,28 +8,88 @@ private:
     unsigned short port;
     int maxClients;
     float updateRate;
+    int maxCatchUpSteps;
+    bool pipelinedBroadcast;
+    int roomCount;
+    int roomWorkers;
+    int jobThreads;
+    bool profiling;
+    unsigned short metricsPort;
+    std::string traceFile;
+    std::string recordFile;
+    std::string replayFile;
+    int keyframeInterval;
+    bool deterministic;
+    std::string worldFile;
+    float checkpointInterval;
     bool verbose;
     std::string logFile;
+    std::string logLevel;
 
 public:
     ServerConfig()
         : port(GameConstants::DEFAULT_PORT),
         maxClients(GameConstants::MAX_CLIENTS),
         updateRate(GameConstants::SERVER_UPDATE_RATE),
+        maxCatchUpSteps(GameConstants::MAX_CATCH_UP_STEPS),
+        pipelinedBroadcast(true),
+        roomCount(1),
+        roomWorkers(0),
+        jobThreads(-1),
+        profiling(true),
+        metricsPort(0),
+        traceFile("server_trace.json"),
+        recordFile(""),
+        replayFile(""),
+        keyframeInterval(100),
+        deterministic(false),
+        worldFile(""),
+        checkpointInterval(30.0f),
         verbose(true),
-        logFile("server_log.txt")
+        logFile("server_log.txt"),
+        logLevel("info")
     {
     }
 
     unsigned short getPort() const { return port; }
     int getMaxClients() const { return maxClients; }
     float getUpdateRate() const { return updateRate; }
+    int getMaxCatchUpSteps() const { return maxCatchUpSteps; }
+    bool isPipelinedBroadcast() const { return pipelinedBroadcast; }
+    int getRoomCount() const { return roomCount; }
+    int getRoomWorkers() const { return roomWorkers; }  // 0 picks one per spare core
+    int getJobThreads() const { return jobThreads; }    // -1 picks one per spare core, 0 runs the tick serially
+    bool isProfiling() const { return profiling; }
+    unsigned short getMetricsPort() const { return metricsPort; }   // 0 turns the endpoint off
+    const std::string& getTraceFile() const { return traceFile; }
+    const std::string& getRecordFile() const { return recordFile; }   // empty: don't record
+    const std::string& getReplayFile() const { return replayFile; }   // non-empty: replay instead of serving
+    int getKeyframeInterval() const { return keyframeInterval; }      // ticks between recorded keyframes
+    bool isDeterministic() const { return deterministic; }            // stamp snapshots with a state hash
+    const std::string& getWorldFile() const { return worldFile; }     // empty: always start a new world
+    float getCheckpointInterval() const { return checkpointInterval; } // seconds, 0 saves only at shutdown
     bool isVerbose() const { return verbose; }
     const std::string& getLogFile() const { return logFile; }
+    const std::string& getLogLevel() const { return logLevel; }
 
     void setPort(unsigned short value) { port = value; }
     void setMaxClients(int value) { maxClients = value; }
     void setUpdateRate(float value) { updateRate = value; }
+    void setMaxCatchUpSteps(int value) { maxCatchUpSteps = value; }
+    void setPipelinedBroadcast(bool value) { pipelinedBroadcast = value; }
+    void setRoomCount(int value) { roomCount = value; }
+    void setRoomWorkers(int value) { roomWorkers = value; }
+    void setJobThreads(int value) { jobThreads = value; }
+    void setProfiling(bool value) { profiling = value; }
+    void setMetricsPort(unsigned short value) { metricsPort = value; }
+    void setTraceFile(const std::string& value) { traceFile = value; }
+    void setRecordFile(const std::string& value) { recordFile = value; }
+    void setReplayFile(const std::string& value) { replayFile = value; }
+    void setKeyframeInterval(int value) { keyframeInterval = value; }
+    void setDeterministic(bool value) { deterministic = value; }
+    void setWorldFile(const std::string& value) { worldFile = value; }
+    void setCheckpointInterval(float value) { checkpointInterval = value; }
     void setVerbose(bool value) { verbose = value; }
     void setLogFile(const std::string& value) { logFile = value; }
+    void setLogLevel(const std::string& value) { logLevel = value; }
 };
\ No newline at end of file
@@ -1,3 +1,180 @@
 // ServerLogger.cpp
 #include "ServerLogger.h"
-// All implementations are in the header
\ No newline at end of file
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+
+ServerLogger::ServerLogger(const std::string& filename, bool outputToConsole)
+    : b(outputToConsole), c(severity(Level::INFO)),
+    d(new Record[RING_CAPACITY]), e(0), f(0), g(0), h(0),
+    j(true), k(-1)
+{
+    static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two");
+
+    for (size_t slot = 0; slot < RING_CAPACITY; slot++) {
+        d[slot].a.store(slot, std::memory_order_relaxed);
+    }
+
+    a.open(filename, std::ios::out | std::ios::app);
+    i = std::thread(&ServerLogger::writerLoop, this);
+}
+
+ServerLogger::~ServerLogger()
+{
+    j = false;
+    if (i.joinable()) {
+        i.join();
+    }
+
+    if (a.is_open()) {
+        a.close();
+    }
+}
+
+int ServerLogger::severity(Level level)
+{
+    switch (level) {
+    case Level::DEBUG:   return 0;
+    case Level::INFO:    return 1;
+    case Level::WARNING: return 2;
+    case Level::ERROR:   return 3;
+    }
+    return 1;
+}
+
+const char* ServerLogger::levelName(Level level)
+{
+    switch (level) {
+    case Level::INFO:    return "INFO";
+    case Level::WARNING: return "WARNING";
+    case Level::ERROR:   return "ERROR";
+    case Level::DEBUG:   return "DEBUG";
+    }
+    return "INFO";
+}
+
+ServerLogger::Level ServerLogger::parseLevel(const std::string& name)
+{
+    if (name == "debug") return Level::DEBUG;
+    if (name == "warning") return Level::WARNING;
+    if (name == "error") return Level::ERROR;
+    return Level::INFO;
+}
+
+void ServerLogger::log(Level level, const std::string& message)
+{
+    if (!isEnabled(level)) return;
+
+    // Claim a slot (bounded MPMC ring; only the writer consumes)
+    size_t position = e.load(std::memory_order_relaxed);
+    Record* record = nullptr;
+    for (;;) {
+        record = &d[position & (RING_CAPACITY - 1)];
+        size_t sequence = record->a.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (diff == 0) {
+            if (e.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            // Full: the writer hasn't caught up with a whole lap. Drop rather than wait
+            g++;
+            return;
+        }
+        else {
+            position = e.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->b = level;
+    record->c = static_cast<long long>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    record->d = std::min(message.size(), RECORD_TEXT_SIZE);
+    std::memcpy(record->e, message.data(), record->d);
+
+    record->a.store(position + 1, std::memory_order_release);
+}
+
+const std::string& ServerLogger::timestampFor(long long second)
+{
+    if (second != k) {
+        std::time_t time = static_cast<std::time_t>(second);
+
+        // Use localtime_s instead of localtime for safety
+        std::tm timeInfo;
+        localtime_s(&timeInfo, &time);
+
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeInfo);
+        l = buffer;
+        k = second;
+    }
+    return l;
+}
+
+bool ServerLogger::drain()
+{
+    size_t position = f.load(std::memory_order_relaxed);
+    m.clear();
+
+    for (;;) {
+        Record& record = d[position & (RING_CAPACITY - 1)];
+        if (record.a.load(std::memory_order_acquire) != position + 1) break;
+
+        m += timestampFor(record.c);
+        m += " [";
+        m += levelName(record.b);
+        m += "] ";
+        m.append(record.e, record.d);
+        m += '\n';
+
+        // Hand the slot back to producers for the next lap
+        record.a.store(position + RING_CAPACITY, std::memory_order_release);
+        position++;
+    }
+
+    unsigned long lost = g - h;
+    if (lost > 0) {
+        h += lost;
+        long long now = static_cast<long long>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        m += timestampFor(now);
+        m += " [WARNING] ";
+        m += std::to_string(lost);
+        m += " log messages dropped\n";
+    }
+
+    if (m.empty()) return false;
+
+    if (a.is_open()) {
+        a.write(m.data(), static_cast<std::streamsize>(m.size()));
+        a.flush();
+    }
+
+    if (b) {
+        std::cout.write(m.data(), static_cast<std::streamsize>(m.size()));
+        std::cout.flush();
+    }
+
+    f.store(position, std::memory_order_release);
+    return true;
+}
+
+void ServerLogger::writerLoop()
+{
+    while (j) {
+        if (!drain()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    // Write out whatever was queued before shutdown
+    while (drain()) {
+    }
+}
+
+void ServerLogger::flush()
+{
+    size_t target = e.load(std::memory_order_acquire);
+    while (j && f.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
\ No newline at end of file
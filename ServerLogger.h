@@ -4,29 +4,22 @@
 #include <fstream>
 #include <iostream>
 #include <chrono>
-#include <iomanip>
-#include <mutex>
-#include <sstream> 
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstddef>
 #include <SFML/Graphics.hpp>
-class ServerLogger {
-private:
-    std::ofstream logFile;
-    bool consoleOutput;
-    std::mutex logMutex;
-
-    std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-
-        // Use localtime_s instead of localtime for safety
-        std::tm timeInfo;
-        localtime_s(&timeInfo, &time);
-
-        std::stringstream ss;
-        ss << std::put_time(&timeInfo, "%Y-%m-%d %H:%M:%S");
-        return ss.str();
-    }
 
+// Asynchronous logger. Callers only copy their message into a slot of a
+// lock-free ring; a background thread stamps, formats and writes the
+// records in batches, one file write and one flush per batch.
+//
+// Drop policy: producers never wait. If the ring is full when a message
+// arrives, that message is discarded and counted, and the writer reports
+// the number lost ("N log messages dropped") with its next batch. Messages
+// longer than a slot are truncated. Anything still queued is written when
+// the logger is destroyed.
+class ServerLogger {
 public:
     enum class Level {
         INFO,
@@ -35,39 +28,55 @@ public:
         DEBUG
     };
 
-    ServerLogger(const std::string& filename, bool outputToConsole = true)
-        : consoleOutput(outputToConsole)
-    {
-        logFile.open(filename, std::ios::out | std::ios::app);
-    }
+    static constexpr size_t RING_CAPACITY = 4096;     // slots, power of two
+    static constexpr size_t RECORD_TEXT_SIZE = 480;   // longest message kept per slot
 
-    ~ServerLogger() {
-        if (logFile.is_open()) {
-            logFile.close();
-        }
-    }
+private:
+    struct Record {
+        std::atomic<size_t> a; // sequence - ring position this slot is ready for
+        Level b; // level
+        long long c; // second - wall-clock second the message was logged
+        size_t d; // length
+        char e[RECORD_TEXT_SIZE]; // text
+    };
 
-    void log(Level level, const std::string& message) {
-        std::string levelStr;
-        switch (level) {
-        case Level::INFO:    levelStr = "INFO"; break;
-        case Level::WARNING: levelStr = "WARNING"; break;
-        case Level::ERROR:   levelStr = "ERROR"; break;
-        case Level::DEBUG:   levelStr = "DEBUG"; break;
-        }
+    std::ofstream a; // logFile
+    bool b; // consoleOutput
+    std::atomic<int> c; // minSeverity
 
-        std::string formattedMsg = getTimestamp() + " [" + levelStr + "] " + message;
+    std::unique_ptr<Record[]> d; // ring
+    std::atomic<size_t> e; // head - next position producers claim
+    std::atomic<size_t> f; // tail - next position the writer reads; advanced after each batch is written
+    std::atomic<unsigned long> g; // dropped
+    unsigned long h; // droppedReported - writer only
 
-        std::lock_guard<std::mutex> lock(logMutex);
+    std::thread i; // writer
+    std::atomic<bool> j; // running
 
-        if (logFile.is_open()) {
-            logFile << formattedMsg << std::endl;
-        }
+    // Writer-side timestamp cache, reformatted at most once per second
+    long long k; // cachedSecond
+    std::string l; // cachedTimestamp
+    std::string m; // batch - the records being written together
 
-        if (consoleOutput) {
-            std::cout << formattedMsg << std::endl;
-        }
-    }
+    void writerLoop();
+    bool drain();
+    const std::string& timestampFor(long long second);
+
+    static int severity(Level level);
+    static const char* levelName(Level level);
+
+public:
+    ServerLogger(const std::string& filename, bool outputToConsole = true);
+    ~ServerLogger();
+
+    ServerLogger(const ServerLogger&) = delete;
+    ServerLogger& operator=(const ServerLogger&) = delete;
+
+    // Messages below this level are discarded before anything is copied or formatted
+    void setMinLevel(Level level) { c = severity(level); }
+    bool isEnabled(Level level) const { return severity(level) >= c.load(std::memory_order_relaxed); }
+
+    void log(Level level, const std::string& message);
 
     void info(const std::string& message) {
         log(Level::INFO, message);
@@ -84,4 +93,14 @@ public:
     void debug(const std::string& message) {
         log(Level::DEBUG, message);
     }
+
+    // Block until everything queued so far has been written
+    void flush();
+
+    unsigned long getDroppedCount() const { return g; }
+    // Messages claimed but not yet written
+    size_t getQueueDepth() const { return e.load(std::memory_order_relaxed) - f.load(std::memory_order_relaxed); }
+
+    // Parse "debug", "info", "warning" or "error"; anything else gives INFO
+    static Level parseLevel(const std::string& name);
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+// ServerMetrics.cpp
+#include "ServerMetrics.h"
+
+ServerMetrics::ServerMetrics()
+    : players(0), planets(0), vehicles(0), pendingValidations(0), pendingCorrections(0),
+    validations(0), corrections(0), correctionsDeferred(0),
+    bytesReceived(0), bytesSent(0), connectionsAccepted(0)
+{
+}
+
+void ServerMetrics::publish(MetricsContribution& last, const MetricsContribution& now)
+{
+    players.fetch_add(now.players - last.players, std::memory_order_relaxed);
+    planets.fetch_add(now.planets - last.planets, std::memory_order_relaxed);
+    vehicles.fetch_add(now.vehicles - last.vehicles, std::memory_order_relaxed);
+    pendingValidations.fetch_add(now.pendingValidations - last.pendingValidations, std::memory_order_relaxed);
+    pendingCorrections.fetch_add(now.pendingCorrections - last.pendingCorrections, std::memory_order_relaxed);
+    validations.fetch_add(now.validations - last.validations, std::memory_order_relaxed);
+    corrections.fetch_add(now.corrections - last.corrections, std::memory_order_relaxed);
+    correctionsDeferred.fetch_add(now.correctionsDeferred - last.correctionsDeferred, std::memory_order_relaxed);
+    last = now;
+}
+
+void ServerMetrics::retract(MetricsContribution& last)
+{
+    MetricsContribution gone = last;
+    gone.players = 0;
+    gone.planets = 0;
+    gone.vehicles = 0;
+    gone.pendingValidations = 0;
+    gone.pendingCorrections = 0;
+    publish(last, gone);
+}
+
+ServerMetrics& ServerMetrics::global()
+{
+    static ServerMetrics metrics;
+    return metrics;
+}
\ No newline at end of file
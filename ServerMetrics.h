@@ -0,0 +1,48 @@
+// ServerMetrics.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// One GameServer's share of the process-wide numbers. Servers publish the
+// difference to what they published last, so several rooms add up.
+struct MetricsContribution {
+    int64_t players;
+    int64_t planets;
+    int64_t vehicles;
+    int64_t pendingValidations;     // client simulations queued for the next tick
+    int64_t pendingCorrections;     // corrections waiting for the next snapshot
+    uint64_t validations;
+    uint64_t corrections;
+    uint64_t correctionsDeferred;
+};
+
+// Counters and gauges read by the metrics endpoint. Everything is a fixed
+// atomic, so updating from the tick is a handful of relaxed adds and never
+// allocates. Histograms come from the TickProfiler and per-connection
+// traffic from the NetworkManager; this only holds what has no other home.
+class ServerMetrics {
+public:
+    std::atomic<int64_t> players;
+    std::atomic<int64_t> planets;
+    std::atomic<int64_t> vehicles;
+    std::atomic<int64_t> pendingValidations;
+    std::atomic<int64_t> pendingCorrections;
+    std::atomic<uint64_t> validations;
+    std::atomic<uint64_t> corrections;
+    std::atomic<uint64_t> correctionsDeferred;
+    std::atomic<uint64_t> bytesReceived;        // all connections, including closed ones
+    std::atomic<uint64_t> bytesSent;
+    std::atomic<uint64_t> connectionsAccepted;
+
+    ServerMetrics();
+
+    ServerMetrics(const ServerMetrics&) = delete;
+    ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+    // Add the change from last to now and remember now
+    void publish(MetricsContribution& last, const MetricsContribution& now);
+    // Take back the gauges of a server that is going away; counters stay
+    void retract(MetricsContribution& last);
+
+    static ServerMetrics& global();
+};
\ No newline at end of file
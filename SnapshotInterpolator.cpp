@@ -0,0 +1,124 @@
+// SnapshotInterpolator.cpp
+#include "SnapshotInterpolator.h"
+#include "GameConstants.h"
+#include <algorithm>
+#include <cmath>
+
+SnapshotBuffer::SnapshotBuffer(size_t capacity)
+    : a(std::max<size_t>(capacity, 2)), b(0), c(0)
+{
+}
+
+bool SnapshotBuffer::push(const RemoteSnapshot& snapshot)
+{
+    if (c > 0 && snapshot.a <= at(c - 1).a) {
+        return false;
+    }
+
+    // Full - overwrite the oldest
+    if (c == a.size()) {
+        b = (b + 1) % a.size();
+        c--;
+    }
+
+    a[(b + c) % a.size()] = snapshot;
+    c++;
+    return true;
+}
+
+bool SnapshotBuffer::sample(float time, float maxExtrapolation, RemoteSnapshot& out) const
+{
+    if (c == 0) return false;
+
+    // Older than anything we have - hold the oldest
+    if (time <= at(0).a) {
+        out = at(0);
+        return true;
+    }
+
+    // Newer than anything we have - extrapolate for a bounded time, then hold
+    const RemoteSnapshot& newest = at(c - 1);
+    if (time >= newest.a) {
+        float ahead = std::min(time - newest.a, maxExtrapolation);
+        out = newest;
+        out.a = newest.a + ahead;
+        out.b = newest.b + newest.c * ahead;
+        return true;
+    }
+
+    // Find the pair of snapshots around the requested time
+    size_t low = 0;
+    size_t high = c - 1;
+    while (high - low > 1) {
+        size_t mid = (low + high) / 2;
+        if (at(mid).a <= time) {
+            low = mid;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    const RemoteSnapshot& p0 = at(low);
+    const RemoteSnapshot& p1 = at(high);
+    float span = p1.a - p0.a;
+    float s = (time - p0.a) / span;
+    float s2 = s * s;
+    float s3 = s2 * s;
+
+    // Cubic Hermite basis - matches both positions and velocities at the ends
+    float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+    float h10 = s3 - 2.0f * s2 + s;
+    float h01 = -2.0f * s3 + 3.0f * s2;
+    float h11 = s3 - s2;
+
+    out.a = time;
+    out.b = p0.b * h00 + p0.c * (h10 * span) + p1.b * h01 + p1.c * (h11 * span);
+
+    // Derivative of the same curve so velocity stays consistent with position
+    float d00 = (6.0f * s2 - 6.0f * s) / span;
+    float d10 = 3.0f * s2 - 4.0f * s + 1.0f;
+    float d01 = (-6.0f * s2 + 6.0f * s) / span;
+    float d11 = 3.0f * s2 - 2.0f * s;
+    out.c = p0.b * d00 + p0.c * d10 + p1.b * d01 + p1.c * d11;
+
+    out.d = p0.d + (p1.d - p0.d) * s;
+    return true;
+}
+
+PlayoutClock::PlayoutClock()
+    : a(0.0f), b(0.0f), c(GameConstants::SERVER_UPDATE_RATE),
+    d(GameConstants::SERVER_UPDATE_RATE), e(0.0f), f(false)
+{
+}
+
+void PlayoutClock::onSnapshot(float localTime, float serverTime)
+{
+    float offset = localTime - serverTime;
+
+    if (!f) {
+        a = offset;
+        e = serverTime;
+        f = true;
+        return;
+    }
+
+    // Ignore snapshots that don't advance server time
+    float interval = serverTime - e;
+    if (interval <= 0.0f) return;
+    e = serverTime;
+
+    // Interarrival jitter estimate, same smoothing as RTP (1/16)
+    float deviation = std::fabs(offset - a);
+    b += (deviation - b) / 16.0f;
+
+    // Offset and send interval follow slowly so clock drift is absorbed
+    a += (offset - a) / 16.0f;
+    c += (interval - c) / 16.0f;
+
+    // Aim one interval plus a jitter margin behind, and ease toward it
+    // so changes in the delay don't show up as jumps
+    float target = c + GameConstants::PLAYOUT_JITTER_FACTOR * b;
+    target = std::max(GameConstants::MIN_PLAYOUT_DELAY, std::min(GameConstants::MAX_PLAYOUT_DELAY, target));
+    d += (target - d) * 0.1f;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+// SnapshotInterpolator.h
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <SFML/System/Vector2.hpp>
+
+// One received state of a remote entity, stamped with server time
+struct RemoteSnapshot {
+    float a; // serverTime
+    sf::Vector2f b; // position
+    sf::Vector2f c; // velocity
+    float d; // rotation
+};
+
+// Time-indexed ring of snapshots for one remote entity
+class SnapshotBuffer {
+private:
+    std::vector<RemoteSnapshot> a; // snapshots - preallocated ring, oldest first from b
+    size_t b; // start
+    size_t c; // count
+
+    const RemoteSnapshot& at(size_t index) const { return a[(b + index) % a.size()]; }
+
+public:
+    explicit SnapshotBuffer(size_t capacity = 32);
+
+    // Add a snapshot; late or duplicate ones (not newer than the newest) are ignored
+    bool push(const RemoteSnapshot& snapshot);
+
+    // State at a server time: Hermite interpolation between the surrounding
+    // snapshots, or extrapolation along the newest velocity for at most
+    // maxExtrapolation seconds when the newer snapshot hasn't arrived
+    bool sample(float time, float maxExtrapolation, RemoteSnapshot& out) const;
+
+    size_t size() const { return c; }
+    float getNewestTime() const { return c ? at(c - 1).a : 0.0f; }
+    void clear() { b = 0; c = 0; }
+};
+
+// Maps local time to the server time remote entities should be drawn at.
+// The playout delay follows the measured snapshot interval and arrival jitter
+// so there is usually a newer snapshot to interpolate toward.
+class PlayoutClock {
+private:
+    float a; // offset - smoothed (local arrival time - server time)
+    float b; // jitter - smoothed deviation of arrival offsets
+    float c; // interval - smoothed server time between snapshots
+    float d; // delay - current playout delay
+    float e; // lastServerTime
+    bool f; // initialized
+
+public:
+    PlayoutClock();
+
+    // Feed the arrival of a snapshot
+    void onSnapshot(float localTime, float serverTime);
+
+    // Server time to render remote entities at, never less than minDelay behind
+    float renderTime(float localTime, float minDelay = 0.0f) const {
+        return localTime - a - (d > minDelay ? d : minDelay);
+    }
+
+    float getDelay() const { return d; }
+    float getJitter() const { return b; }
+    float getInterval() const { return c; }
+    bool isInitialized() const { return f; }
+};
\ No newline at end of file
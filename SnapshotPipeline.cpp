@@ -0,0 +1,160 @@
+// SnapshotPipeline.cpp
+#include "SnapshotPipeline.h"
+#include "NetworkManager.h"
+#include "TraceRecorder.h"
+#include "Log.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+SnapshotPipeline::SnapshotPipeline(NetworkManager& network)
+    : a(network), e(false),
+    h(0), i(0), j(0), k(0)
+{
+}
+
+SnapshotPipeline::~SnapshotPipeline()
+{
+    stop();
+}
+
+void SnapshotPipeline::start()
+{
+    std::lock_guard<std::mutex> lock(c);
+    if (e) return;
+
+    e = true;
+    b = std::thread(&SnapshotPipeline::run, this);
+}
+
+void SnapshotPipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(c);
+        if (!e) return;
+        e = false;
+    }
+    d.notify_one();
+
+    if (b.joinable()) {
+        b.join();
+    }
+}
+
+void SnapshotPipeline::publish(GameState& state, std::vector<int>& corrections)
+{
+    {
+        std::lock_guard<std::mutex> lock(c);
+
+        std::swap(f.a, state);
+        std::swap(f.b, corrections);
+
+        // An unsent snapshot's corrections were already counted and rate
+        // limited, so they go out with the newer state instead of being lost
+        if (f.d) {
+            for (int playerId : corrections) {
+                if (std::find(f.b.begin(), f.b.end(), playerId) == f.b.end()) {
+                    f.b.push_back(playerId);
+                }
+            }
+            j++;
+        }
+
+        f.c = std::chrono::steady_clock::now();
+        f.d = true;
+        h++;
+    }
+    d.notify_one();
+
+    corrections.clear();
+}
+
+void SnapshotPipeline::run()
+{
+    TraceRecorder::setThreadName("snapshot worker");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(c);
+            d.wait(lock, [this]() { return f.d || !e; });
+
+            // Finish the last snapshot before shutting down
+            if (!f.d) break;
+
+            std::swap(g, f);
+            f.d = false;
+        }
+
+        auto sendStart = std::chrono::steady_clock::now();
+        bool succeeded = false;
+        try {
+            TraceScope trace("snapshot_send");
+            succeeded = a.sendGameState(g.a, g.b);
+        }
+        catch (const std::exception& ex) {
+            KLOG_ERROR(NET, "exception", "where", "snapshotWorker", "error", ex.what());
+        }
+        auto sendEnd = std::chrono::steady_clock::now();
+        g.d = false;
+
+        std::lock_guard<std::mutex> lock(c);
+        float sendSeconds = std::chrono::duration<float>(sendEnd - sendStart).count();
+        float latencySeconds = std::chrono::duration<float>(sendEnd - g.c).count();
+
+        l.lastSeconds = sendSeconds;
+        l.maxSeconds = std::max(l.maxSeconds, sendSeconds);
+        l.totalSeconds += sendSeconds;
+        l.samples++;
+
+        m.lastSeconds = latencySeconds;
+        m.maxSeconds = std::max(m.maxSeconds, latencySeconds);
+        m.totalSeconds += latencySeconds;
+        m.samples++;
+
+        i++;
+        if (!succeeded) k++;
+    }
+}
+
+void SnapshotPipeline::logStats(ServerLogger& logger)
+{
+    std::stringstream ss;
+    {
+        std::lock_guard<std::mutex> lock(c);
+
+        ss << std::fixed << std::setprecision(3);
+        ss << "Snapshot pipeline: " << h << " published, " << i << " sent, "
+            << j << " superseded, " << k << " with send failures"
+            << ", send avg " << l.averageSeconds() * 1000.0f << "ms"
+            << " max " << l.maxSeconds * 1000.0f << "ms"
+            << ", freeze-to-sent avg " << m.averageSeconds() * 1000.0f << "ms"
+            << " max " << m.maxSeconds * 1000.0f << "ms";
+
+        h = 0;
+        i = 0;
+        j = 0;
+        k = 0;
+        l = PhaseTiming();
+        m = PhaseTiming();
+    }
+
+    logger.info(ss.str());
+}
+
+PhaseTiming SnapshotPipeline::getSendTiming()
+{
+    std::lock_guard<std::mutex> lock(c);
+    return l;
+}
+
+PhaseTiming SnapshotPipeline::getLatencyTiming()
+{
+    std::lock_guard<std::mutex> lock(c);
+    return m;
+}
+
+unsigned long SnapshotPipeline::getSupersededCount()
+{
+    std::lock_guard<std::mutex> lock(c);
+    return j;
+}
\ No newline at end of file
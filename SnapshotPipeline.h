@@ -0,0 +1,71 @@
+// SnapshotPipeline.h
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "GameState.h"
+#include "TickScheduler.h"
+#include "ServerLogger.h"
+
+class NetworkManager;
+
+// A tick's world state, frozen once the simulation step is done
+struct FrozenSnapshot {
+    GameState a; // state
+    std::vector<int> b; // corrections - players flagged for correction in this snapshot
+    std::chrono::steady_clock::time_point c; // frozenAt
+    bool d = false; // valid
+};
+
+// Serializes and sends snapshots on a worker thread so the simulation can
+// start on the next tick straight away.
+//
+// Two buffers are swapped, never copied: the simulation thread fills the
+// pending one while the worker sends the other. If the worker is still busy
+// when a newer snapshot is published, the unsent pending one is replaced -
+// clients only ever want the newest state.
+class SnapshotPipeline {
+private:
+    NetworkManager& a; // network
+
+    std::thread b; // worker
+    std::mutex c; // mutex
+    std::condition_variable d; // wakeUp
+    bool e; // running
+
+    FrozenSnapshot f; // pending - published, not yet picked up by the worker
+    FrozenSnapshot g; // sending - owned by the worker while it sends
+
+    // Statistics since the last report, guarded by c
+    unsigned long h; // published
+    unsigned long i; // sent
+    unsigned long j; // superseded - replaced before the worker got to them
+    unsigned long k; // sendFailures
+    PhaseTiming l; // sendTiming - serialize + send on the worker
+    PhaseTiming m; // latencyTiming - frozen to last byte handed to the sockets
+
+    void run();
+
+public:
+    explicit SnapshotPipeline(NetworkManager& network);
+    ~SnapshotPipeline();
+
+    void start();
+
+    // Send whatever is still pending, then join the worker
+    void stop();
+
+    // Hand over a frozen tick; state and corrections are swapped in rather
+    // than copied, and corrections comes back empty. Replacing an unsent
+    // snapshot keeps its corrections along with the new ones
+    void publish(GameState& state, std::vector<int>& corrections);
+
+    void logStats(ServerLogger& logger);
+
+    // Copies of the running statistics (reset by logStats)
+    PhaseTiming getSendTiming();
+    PhaseTiming getLatencyTiming();
+    unsigned long getSupersededCount();
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+// StateHistory.cpp
+#include "StateHistory.h"
+#include <cmath>
+#include <algorithm>
+
+StateHistory::StateHistory(float windowSeconds, float tickInterval, int maxEntities)
+    : e(static_cast<size_t>(std::max(1, maxEntities))), f(0), g(0), h(0)
+{
+    // Keep enough ticks to cover the window, plus one so the window is fully bracketed
+    float interval = tickInterval > 0.0f ? tickInterval : 0.05f;
+    f = static_cast<size_t>(std::ceil(windowSeconds / interval)) + 1;
+    if (f < 2) f = 2;
+
+    a.assign(f, 0.0f);
+    b.assign(f, 0);
+    d.assign(f, 0);
+    c.assign(f * e, HistoryEntry{ -1, sf::Vector2f(0, 0), sf::Vector2f(0, 0), 0.0f });
+}
+
+void StateHistory::beginTick(unsigned long sequence, float time)
+{
+    a[g] = time;
+    b[g] = sequence;
+    d[g] = 0;
+
+    g = (g + 1) % f;
+    if (h < f) {
+        h++;
+    }
+}
+
+void StateHistory::record(int playerId, const sf::Vector2f& position, const sf::Vector2f& velocity, float rotation)
+{
+    if (h == 0) return;
+
+    // Write into the tick most recently started
+    size_t slot = slotAt(h - 1);
+    int used = d[slot];
+
+    // Players beyond the reserved slots are not recorded and validate against live state
+    if (used >= static_cast<int>(e)) return;
+
+    HistoryEntry& entry = c[slot * e + used];
+    entry.a = playerId;
+    entry.b = position;
+    entry.c = velocity;
+    entry.d = rotation;
+    d[slot] = used + 1;
+}
+
+const HistoryEntry* StateHistory::findEntry(size_t slot, int playerId) const
+{
+    const HistoryEntry* entries = &c[slot * e];
+    for (int n = 0; n < d[slot]; n++) {
+        if (entries[n].a == playerId) {
+            return &entries[n];
+        }
+    }
+    return nullptr;
+}
+
+bool StateHistory::sample(int playerId, float time, HistoryEntry& out) const
+{
+    if (h == 0 || playerId < 0) return false;
+
+    // Binary search for the last tick at or before the requested time
+    size_t low = 0;
+    size_t high = h;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (a[slotAt(mid)] <= time) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    // Requested time is older than the window - clamp to the oldest tick
+    if (low == 0) {
+        const HistoryEntry* oldest = findEntry(slotAt(0), playerId);
+        if (!oldest) return false;
+        out = *oldest;
+        return true;
+    }
+
+    size_t beforeSlot = slotAt(low - 1);
+    const HistoryEntry* before = findEntry(beforeSlot, playerId);
+
+    // Requested time is at or past the newest tick
+    if (low == h) {
+        if (!before) return false;
+        out = *before;
+        return true;
+    }
+
+    size_t afterSlot = slotAt(low);
+    const HistoryEntry* after = findEntry(afterSlot, playerId);
+
+    // Player joined or left between the two ticks - use whichever side exists
+    if (!before || !after) {
+        const HistoryEntry* known = before ? before : after;
+        if (!known) return false;
+        out = *known;
+        return true;
+    }
+
+    float span = a[afterSlot] - a[beforeSlot];
+    float factor = span > 0.0f ? (time - a[beforeSlot]) / span : 0.0f;
+
+    out.a = playerId;
+    out.b = before->b + (after->b - before->b) * factor;
+    out.c = before->c + (after->c - before->c) * factor;
+    out.d = before->d + (after->d - before->d) * factor;
+    return true;
+}
+
+void StateHistory::forget(int playerId)
+{
+    for (auto& entry : c) {
+        if (entry.a == playerId) {
+            entry.a = -1;
+        }
+    }
+}
+
+void StateHistory::clear()
+{
+    std::fill(d.begin(), d.end(), 0);
+    g = 0;
+    h = 0;
+}
\ No newline at end of file
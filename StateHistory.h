@@ -0,0 +1,52 @@
+// StateHistory.h
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <SFML/System/Vector2.hpp>
+
+// Compact per-player sample stored for each recorded tick
+struct HistoryEntry {
+    int a; // playerId - -1 marks an unused or forgotten slot
+    sf::Vector2f b; // position
+    sf::Vector2f c; // velocity
+    float d; // rotation
+};
+
+// Fixed-size ring of recent world states used to rewind the server to a
+// client's timestamp. All storage is allocated once in the constructor, so
+// recording a tick never touches the heap.
+class StateHistory {
+private:
+    std::vector<float> a; // tickTimes - game time of each stored tick
+    std::vector<unsigned long> b; // tickSequences - sequence number of each stored tick
+    std::vector<HistoryEntry> c; // entries - e slots per tick, flattened
+    std::vector<int> d; // entryCounts - number of used slots per tick
+    size_t e; // maxEntities - slots reserved per tick
+    size_t f; // capacity - number of ticks kept
+    size_t g; // head - slot the next tick is written to
+    size_t h; // count - number of valid ticks
+
+    size_t slotAt(size_t index) const { return (g + f - h + index) % f; }
+    const HistoryEntry* findEntry(size_t slot, int playerId) const;
+
+public:
+    StateHistory(float windowSeconds, float tickInterval, int maxEntities);
+
+    // Start a new tick, overwriting the oldest one once the ring is full
+    void beginTick(unsigned long sequence, float time);
+    // Add a player sample to the tick started by beginTick
+    void record(int playerId, const sf::Vector2f& position, const sf::Vector2f& velocity, float rotation);
+
+    // Reconstruct a player's state at the given time, interpolating between
+    // the two surrounding ticks. Times outside the window clamp to its edges.
+    bool sample(int playerId, float time, HistoryEntry& out) const;
+
+    // Drop all samples for a player (player IDs get reused after disconnects)
+    void forget(int playerId);
+    void clear();
+
+    size_t size() const { return h; }
+    size_t capacity() const { return f; }
+    float getOldestTime() const { return h ? a[slotAt(0)] : 0.0f; }
+    float getNewestTime() const { return h ? a[slotAt(h - 1)] : 0.0f; }
+};
\ No newline at end of file
@@ -0,0 +1,176 @@
+// TickProfiler.cpp
+#include "TickProfiler.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+std::atomic<TickProfiler*> TickProfiler::g(nullptr);
+
+namespace {
+    int highestBit(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+    }
+}
+
+int HistogramSnapshot::bucketFor(uint64_t nanos)
+{
+    const uint64_t linearLimit = static_cast<uint64_t>(HALF_SUB_BUCKETS) * 2;
+    if (nanos < linearLimit) return static_cast<int>(nanos);
+
+    const uint64_t largest = (static_cast<uint64_t>(1) << MAX_MAGNITUDE) - 1;
+    nanos = std::min(nanos, largest);
+
+    int shift = highestBit(nanos) - (SUB_BUCKET_BITS - 1);
+    int subBucket = static_cast<int>(nanos >> shift);
+    return (shift + 1) * HALF_SUB_BUCKETS + (subBucket - HALF_SUB_BUCKETS);
+}
+
+uint64_t HistogramSnapshot::bucketUpperBound(int bucket)
+{
+    if (bucket < HALF_SUB_BUCKETS * 2) return static_cast<uint64_t>(bucket);
+
+    int shift = bucket / HALF_SUB_BUCKETS - 1;
+    uint64_t subBucket = static_cast<uint64_t>(bucket % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS);
+    return ((subBucket + 1) << shift) - 1;
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const
+{
+    if (count == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count) + 0.5);
+    rank = std::max<uint64_t>(1, std::min(rank, count));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) return bucketUpperBound(i);
+    }
+    return bucketUpperBound(BUCKET_COUNT - 1);
+}
+
+void HistogramSnapshot::subtract(const HistogramSnapshot& earlier)
+{
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] -= earlier.counts[i];
+    }
+    count -= earlier.count;
+    sumNanos -= earlier.sumNanos;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : b(0), c(0), d(0)
+{
+    for (auto& bucket : a) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(uint64_t nanos)
+{
+    a[HistogramSnapshot::bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+    b.fetch_add(1, std::memory_order_relaxed);
+    c.fetch_add(nanos, std::memory_order_relaxed);
+
+    uint64_t previous = d.load(std::memory_order_relaxed);
+    while (nanos > previous && !d.compare_exchange_weak(previous, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::snapshot(HistogramSnapshot& out) const
+{
+    // Not one atomic cut: a sample recorded meanwhile may show in its bucket
+    // but not the total. The count is rebuilt from the buckets so they agree
+    uint64_t total = 0;
+    for (int i = 0; i < HistogramSnapshot::BUCKET_COUNT; i++) {
+        out.counts[i] = a[i].load(std::memory_order_relaxed);
+        total += out.counts[i];
+    }
+    out.count = total;
+    out.sumNanos = c.load(std::memory_order_relaxed);
+}
+
+TickProfiler::TickProfiler()
+    : d(), e(), f()
+{
+    for (int i = 0; i < static_cast<int>(ProfilePhase::COUNT); i++) {
+        b[i].store(0, std::memory_order_relaxed);
+        c[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void TickProfiler::record(ProfilePhase phase, Clock::duration elapsed)
+{
+    int index = static_cast<int>(phase);
+    uint64_t nanos = static_cast<uint64_t>(std::max<long long>(0,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+
+    a[index].record(nanos);
+
+    uint64_t budget = b[index].load(std::memory_order_relaxed);
+    if (budget > 0 && nanos > budget) {
+        c[index].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TickProfiler::setBudget(ProfilePhase phase, float seconds)
+{
+    b[static_cast<int>(phase)].store(static_cast<uint64_t>(std::max(0.0f, seconds) * 1e9f), std::memory_order_relaxed);
+}
+
+void TickProfiler::logStats(ServerLogger& logger)
+{
+    for (int i = 0; i < static_cast<int>(ProfilePhase::COUNT); i++) {
+        a[i].snapshot(f);
+        HistogramSnapshot current = f;
+        f.subtract(d[i]);
+        d[i] = current;
+
+        uint64_t windowMax = a[i].takeWindowMax();
+        uint64_t over = c[i].load(std::memory_order_relaxed);
+        uint64_t overSinceReport = over - e[i];
+        e[i] = over;
+
+        if (f.count == 0) continue;
+
+        std::stringstream ss;
+        // Microseconds: most phases are far below a millisecond
+        ss << std::fixed << std::setprecision(1)
+            << "Profile " << phaseName(static_cast<ProfilePhase>(i)) << ": " << f.count << " samples"
+            << ", p50 " << f.percentile(0.50) / 1e3 << "us"
+            << ", p99 " << f.percentile(0.99) / 1e3 << "us"
+            << ", max " << windowMax / 1e3 << "us";
+
+        if (b[i].load(std::memory_order_relaxed) > 0) {
+            ss << ", " << overSinceReport << " over budget";
+        }
+
+        if (overSinceReport > 0) {
+            logger.warning(ss.str());
+        }
+        else {
+            logger.info(ss.str());
+        }
+    }
+}
+
+const char* TickProfiler::phaseName(ProfilePhase phase)
+{
+    switch (phase) {
+    case ProfilePhase::TICK:              return "tick";
+    case ProfilePhase::RECEIVE:           return "receive";
+    case ProfilePhase::SIMULATION:        return "simulation";
+    case ProfilePhase::BROADCAST:         return "broadcast";
+    case ProfilePhase::GRAVITY:           return "gravity";
+    case ProfilePhase::PLANET_COLLISIONS: return "planet_collisions";
+    case ProfilePhase::VEHICLE_UPDATE:    return "vehicle_update";
+    case ProfilePhase::GAME_STATE:        return "game_state";
+    case ProfilePhase::SERIALIZE:         return "serialize";
+    case ProfilePhase::SOCKET_SEND:       return "socket_send";
+    default:                              return "unknown";
+    }
+}
\ No newline at end of file
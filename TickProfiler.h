@@ -0,0 +1,134 @@
+// TickProfiler.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "ServerLogger.h"
+#include "TraceRecorder.h"
+
+// Instrumented parts of the tick. The first four wrap the TickScheduler
+// phases; the rest sit inside the simulation and network code
+enum class ProfilePhase {
+    TICK,
+    RECEIVE,
+    SIMULATION,
+    BROADCAST,
+    GRAVITY,
+    PLANET_COLLISIONS,
+    VEHICLE_UPDATE,
+    GAME_STATE,
+    SERIALIZE,
+    SOCKET_SEND,
+    COUNT
+};
+
+// Point-in-time copy of a LatencyHistogram, safe to read and subtract
+struct HistogramSnapshot {
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int HALF_SUB_BUCKETS = 1 << (SUB_BUCKET_BITS - 1);
+    static constexpr int MAX_MAGNITUDE = 36;     // values up to 2^36 ns (about 68 s)
+    static constexpr int BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) * HALF_SUB_BUCKETS;
+
+    uint64_t counts[BUCKET_COUNT];
+    uint64_t count;
+    uint64_t sumNanos;
+
+    // Bucket a value falls into; buckets are linear within each power of two
+    static int bucketFor(uint64_t nanos);
+    // Largest value that lands in a bucket
+    static uint64_t bucketUpperBound(int bucket);
+
+    // Value at quantile q (0..1), rounded up to its bucket's upper bound
+    uint64_t percentile(double q) const;
+
+    // Turn a cumulative snapshot into the samples recorded since an earlier one
+    void subtract(const HistogramSnapshot& earlier);
+};
+
+// Lock-free log-linear histogram in the spirit of HdrHistogram: each power of
+// two is split into 16 linear buckets, so any value is kept to within 1/16
+// in a fixed array. Recording is a few relaxed atomic adds, safe from any
+// thread. Counts are cumulative; take snapshots and subtract for windows.
+class LatencyHistogram {
+private:
+    std::atomic<uint64_t> a[HistogramSnapshot::BUCKET_COUNT]; // counts
+    std::atomic<uint64_t> b; // count
+    std::atomic<uint64_t> c; // sumNanos
+    std::atomic<uint64_t> d; // windowMax - largest value since takeWindowMax
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanos);
+    void snapshot(HistogramSnapshot& out) const;
+    uint64_t takeWindowMax() { return d.exchange(0, std::memory_order_relaxed); }
+    uint64_t getCount() const { return b.load(std::memory_order_relaxed); }
+};
+
+// Per-phase latency histograms for the server tick, plus how often a phase
+// went over its budget (the TICK phase's budget is the tick interval).
+//
+// Code marks a region with a ProfileScope. Scopes report to the profiler
+// installed with install(); with none installed they cost one branch.
+class TickProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    LatencyHistogram a[static_cast<int>(ProfilePhase::COUNT)]; // histograms
+    std::atomic<uint64_t> b[static_cast<int>(ProfilePhase::COUNT)]; // budgets - ns, 0 = none
+    std::atomic<uint64_t> c[static_cast<int>(ProfilePhase::COUNT)]; // overBudget
+    HistogramSnapshot d[static_cast<int>(ProfilePhase::COUNT)]; // lastReport - logStats only
+    uint64_t e[static_cast<int>(ProfilePhase::COUNT)]; // overBudgetAtLastReport
+    HistogramSnapshot f; // scratch
+
+    static std::atomic<TickProfiler*> g; // active
+
+public:
+    TickProfiler();
+
+    TickProfiler(const TickProfiler&) = delete;
+    TickProfiler& operator=(const TickProfiler&) = delete;
+
+    // Make this the profiler ProfileScopes report to (nullptr turns profiling off)
+    static void install(TickProfiler* profiler) { g.store(profiler, std::memory_order_release); }
+    static TickProfiler* current() { return g.load(std::memory_order_relaxed); }
+
+    void record(ProfilePhase phase, Clock::duration elapsed);
+    void setBudget(ProfilePhase phase, float seconds);
+
+    const LatencyHistogram& getHistogram(ProfilePhase phase) const { return a[static_cast<int>(phase)]; }
+    uint64_t getOverBudgetCount(ProfilePhase phase) const { return c[static_cast<int>(phase)].load(std::memory_order_relaxed); }
+
+    // Log p50/p99/max and over-budget counts for each phase since the last report
+    void logStats(ServerLogger& logger);
+
+    static const char* phaseName(ProfilePhase phase);
+};
+
+// Times the enclosing scope into a phase of the installed profiler, and
+// marks it in the trace while one is being recorded
+class ProfileScope {
+private:
+    TickProfiler* a; // profiler - nullptr when none is installed
+    ProfilePhase b; // phase
+    bool c; // traced
+    TickProfiler::Clock::time_point d; // start
+
+public:
+    explicit ProfileScope(ProfilePhase phase)
+        : a(TickProfiler::current()), b(phase), c(TraceRecorder::isRecording())
+    {
+        if (a) d = TickProfiler::Clock::now();
+        if (c) TraceRecorder::record(TickProfiler::phaseName(phase), 'B');
+    }
+
+    ~ProfileScope() {
+        if (c) TraceRecorder::record(TickProfiler::phaseName(b), 'E');
+        if (a) a->record(b, TickProfiler::Clock::now() - d);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
\ No newline at end of file
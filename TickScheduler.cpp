@@ -0,0 +1,199 @@
+// TickScheduler.cpp
+#include "TickScheduler.h"
+#include "TickProfiler.h"
+#include "TraceRecorder.h"
+#include <thread>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <time.h>
+#include <cerrno>
+#endif
+
+namespace {
+    // Without a precise absolute sleep, wake this early and yield the rest
+    constexpr std::chrono::milliseconds SPIN_WINDOW(2);
+}
+
+TickScheduler::TickScheduler(float tickSeconds, int maxCatchUpSteps)
+    : a(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(tickSeconds))),
+    b(tickSeconds),
+    c(maxCatchUpSteps > 0 ? maxCatchUpSteps : 1),
+    f(Clock::duration::zero()),
+    g(false),
+    l(0), m(0), n(0), o(0.0f), p(0.0f),
+    q(0), r(0), s(0.0f)
+{
+}
+
+void TickScheduler::sleepUntil(Clock::time_point deadline)
+{
+#if defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC here, so the deadline can be handed to the kernel as is
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+    timespec target;
+    target.tv_sec = static_cast<time_t>(sinceEpoch.count() / 1000000000LL);
+    target.tv_nsec = static_cast<long>(sinceEpoch.count() % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+    }
+#else
+    // Timed sleeps round up to the scheduler quantum, so sleep short and yield up to the deadline
+    if (Clock::now() + SPIN_WINDOW < deadline) {
+        std::this_thread::sleep_until(deadline - SPIN_WINDOW);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+void TickScheduler::recordPhase(TickPhase phase, Clock::time_point start, Clock::time_point end)
+{
+    PhaseTiming& timing = k[static_cast<int>(phase)];
+    float seconds = std::chrono::duration<float>(end - start).count();
+    timing.lastSeconds = seconds;
+    timing.maxSeconds = std::max(timing.maxSeconds, seconds);
+    timing.totalSeconds += seconds;
+    timing.samples++;
+
+    if (TickProfiler* profiler = TickProfiler::current()) {
+        static const ProfilePhase profilePhases[] = { ProfilePhase::RECEIVE, ProfilePhase::SIMULATION, ProfilePhase::BROADCAST };
+        profiler->record(profilePhases[static_cast<int>(phase)], end - start);
+    }
+}
+
+int TickScheduler::runFrame()
+{
+    if (!g) {
+        e = Clock::now();
+        d = e + a;
+        g = true;
+    }
+
+    sleepUntil(d);
+
+    Clock::time_point frameStart = Clock::now();
+    TraceRecorder::begin("tick");
+    s = std::chrono::duration<float>(frameStart - e).count();
+    f += frameStart - e;
+    e = frameStart;
+
+    // Network receive
+    if (h) {
+        TraceScope trace("receive");
+        h();
+    }
+    Clock::time_point receiveEnd = Clock::now();
+    recordPhase(TickPhase::NETWORK_RECEIVE, frameStart, receiveEnd);
+
+    // Simulation: fixed steps out of the accumulated time
+    int stepsRun = 0;
+    while (f >= a && stepsRun < c) {
+        if (i) {
+            TraceScope trace("simulation");
+            i(b);
+        }
+        f -= a;
+        stepsRun++;
+    }
+
+    // Still behind after the allowed steps - drop whole steps, keep the fraction
+    if (f >= a) {
+        auto behind = f / a;
+        r += static_cast<unsigned long>(behind);
+        f -= a * behind;
+    }
+
+    Clock::time_point simulationEnd = Clock::now();
+    if (stepsRun > 0) {
+        recordPhase(TickPhase::SIMULATION, receiveEnd, simulationEnd);
+    }
+    if (stepsRun > 1) {
+        q++;
+    }
+
+    // Broadcast once per frame, however many steps ran
+    Clock::time_point broadcastEnd = simulationEnd;
+    if (stepsRun > 0) {
+        if (j) {
+            TraceScope trace("broadcast");
+            j();
+        }
+        broadcastEnd = Clock::now();
+        recordPhase(TickPhase::BROADCAST, simulationEnd, broadcastEnd);
+    }
+
+    l++;
+    m += stepsRun;
+
+    TraceRecorder::end("tick");
+    if (TickProfiler* profiler = TickProfiler::current()) {
+        profiler->record(ProfilePhase::TICK, broadcastEnd - frameStart);
+    }
+
+    // Next deadline stays on the fixed grid; if this frame ran past it, record
+    // the overrun and skip to the next grid point still in the future
+    d += a;
+    o = 0.0f;
+    if (broadcastEnd > d) {
+        o = std::chrono::duration<float>(broadcastEnd - d).count();
+        p = std::max(p, o);
+        n++;
+
+        auto missed = (broadcastEnd - d) / a + 1;
+        d += a * missed;
+    }
+
+    return stepsRun;
+}
+
+void TickScheduler::logStats(ServerLogger& logger)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Tick stats: " << l << " frames, " << m << " steps";
+
+    for (int index = 0; index < static_cast<int>(TickPhase::COUNT); index++) {
+        const PhaseTiming& timing = k[index];
+        ss << ", " << phaseName(static_cast<TickPhase>(index))
+            << " avg " << timing.averageSeconds() * 1000.0f << "ms"
+            << " max " << timing.maxSeconds * 1000.0f << "ms";
+    }
+
+    ss << ", " << n << " overruns (max " << p * 1000.0f << "ms)"
+        << ", " << q << " catch-up frames, " << r << " dropped steps";
+
+    if (n > 0 || r > 0) {
+        logger.warning(ss.str());
+    }
+    else {
+        logger.info(ss.str());
+    }
+
+    resetStats();
+}
+
+void TickScheduler::resetStats()
+{
+    for (auto& timing : k) {
+        timing = PhaseTiming();
+    }
+    l = 0;
+    m = 0;
+    n = 0;
+    p = 0.0f;
+    q = 0;
+    r = 0;
+}
+
+const char* TickScheduler::phaseName(TickPhase phase)
+{
+    switch (phase) {
+    case TickPhase::NETWORK_RECEIVE: return "receive";
+    case TickPhase::SIMULATION:      return "simulation";
+    case TickPhase::BROADCAST:       return "broadcast";
+    default:                         return "unknown";
+    }
+}
\ No newline at end of file
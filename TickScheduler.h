@@ -0,0 +1,92 @@
+// TickScheduler.h
+#pragma once
+#include <chrono>
+#include <functional>
+#include <string>
+#include "ServerLogger.h"
+
+// The parts of a server frame, in the order they run
+enum class TickPhase {
+    NETWORK_RECEIVE,
+    SIMULATION,
+    BROADCAST,
+    COUNT
+};
+
+// Timing of one phase since the last report
+struct PhaseTiming {
+    float lastSeconds = 0.0f;
+    float maxSeconds = 0.0f;
+    double totalSeconds = 0.0;
+    unsigned long samples = 0;
+
+    float averageSeconds() const { return samples ? static_cast<float>(totalSeconds / samples) : 0.0f; }
+};
+
+// Runs the server at a fixed simulation step.
+//
+// Each frame sleeps until an absolute deadline (so pacing error doesn't
+// accumulate), receives network input, runs as many fixed steps as the
+// accumulated time allows, then broadcasts once. When the server falls behind
+// it runs at most maxCatchUpSteps steps in one frame and drops the rest of the
+// backlog rather than spiralling.
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::duration a; // tickInterval
+    float b; // tickSeconds
+    int c; // maxCatchUpSteps
+
+    Clock::time_point d; // nextDeadline
+    Clock::time_point e; // lastFrameTime
+    Clock::duration f; // accumulator - time not yet simulated
+    bool g; // started
+
+    std::function<void()> h; // receivePhase
+    std::function<void(float)> i; // simulationPhase
+    std::function<void()> j; // broadcastPhase
+
+    // Statistics since the last report
+    PhaseTiming k[static_cast<int>(TickPhase::COUNT)]; // phaseTimings
+    unsigned long l; // frames
+    unsigned long m; // steps
+    unsigned long n; // overruns - frames that finished after the next deadline
+    float o; // lastOverrunSeconds
+    float p; // maxOverrunSeconds
+    unsigned long q; // catchUpFrames - frames that ran more than one step
+    unsigned long r; // droppedSteps - steps discarded by the catch-up limit
+    float s; // lastFrameInterval
+
+    void recordPhase(TickPhase phase, Clock::time_point start, Clock::time_point end);
+
+public:
+    TickScheduler(float tickSeconds, int maxCatchUpSteps);
+
+    void setReceivePhase(std::function<void()> callback) { h = std::move(callback); }
+    void setSimulationPhase(std::function<void(float)> callback) { i = std::move(callback); }
+    void setBroadcastPhase(std::function<void()> callback) { j = std::move(callback); }
+
+    // Wait for the next deadline and run one frame; returns the number of simulation steps run
+    int runFrame();
+
+    // Sleep until an absolute time, as close to it as the platform allows
+    static void sleepUntil(Clock::time_point deadline);
+
+    void setMaxCatchUpSteps(int value) { c = value > 0 ? value : 1; }
+    int getMaxCatchUpSteps() const { return c; }
+    float getTickSeconds() const { return b; }
+
+    const PhaseTiming& getPhaseTiming(TickPhase phase) const { return k[static_cast<int>(phase)]; }
+    unsigned long getOverrunCount() const { return n; }
+    float getLastOverrun() const { return o; }
+    unsigned long getDroppedSteps() const { return r; }
+    float getLastFrameInterval() const { return s; }
+
+    // Log per-phase timing, overruns and catch-up since the last report, then reset
+    void logStats(ServerLogger& logger);
+    void resetStats();
+
+    static const char* phaseName(TickPhase phase);
+};
\ No newline at end of file
@@ -0,0 +1,202 @@
+// TraceRecorder.cpp
+#include "TraceRecorder.h"
+#include "ServerLogger.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+std::atomic<bool> TraceRecorder::g(false);
+std::atomic<TraceRecorder*> TraceRecorder::h(nullptr);
+std::atomic<uint64_t> TraceRecorder::i(1);
+
+namespace {
+    // The calling thread's buffer in the recorder of the given generation
+    struct ThreadTraceState {
+        uint64_t a = 0; // generation
+        void* b = nullptr; // buffer
+        const char* c = nullptr; // name - set before the thread's buffer exists
+    };
+
+    thread_local ThreadTraceState threadState;
+
+    int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            TraceRecorder::Clock::now().time_since_epoch()).count();
+    }
+}
+
+TraceRecorder::TraceRecorder(const std::string& path, ServerLogger& logger)
+    : a(path), b(logger), c(i++), f(Clock::now())
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    if (h.load() == this) {
+        install(nullptr);
+    }
+}
+
+void TraceRecorder::install(TraceRecorder* recorder)
+{
+    TraceRecorder* previous = h.load();
+    if (previous && previous != recorder && isRecording()) {
+        previous->stop();
+    }
+    h.store(recorder, std::memory_order_release);
+}
+
+void TraceRecorder::record(const char* name, char phase)
+{
+    TraceRecorder* recorder = h.load(std::memory_order_acquire);
+    if (recorder) {
+        recorder->append(name, phase);
+    }
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    threadState.c = name;
+
+    TraceRecorder* recorder = h.load(std::memory_order_acquire);
+    if (recorder) {
+        ThreadBuffer* buffer = recorder->bufferForThisThread();
+        std::lock_guard<std::mutex> lock(recorder->d);
+        buffer->e = name;
+    }
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::bufferForThisThread()
+{
+    if (threadState.a == c) {
+        return static_cast<ThreadBuffer*>(threadState.b);
+    }
+
+    std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+    buffer->a.reset(new Event[EVENTS_PER_THREAD]);
+    buffer->b = 0;
+    buffer->c = 0;
+    buffer->e = threadState.c;
+
+    std::lock_guard<std::mutex> lock(d);
+    buffer->d = static_cast<int>(e.size()) + 1;
+    e.push_back(std::move(buffer));
+
+    threadState.a = c;
+    threadState.b = e.back().get();
+    return e.back().get();
+}
+
+void TraceRecorder::append(const char* name, char phase)
+{
+    ThreadBuffer* buffer = bufferForThisThread();
+
+    // Only this thread writes its buffer; the count is published after the
+    // event so the file writer never reads a half-written one
+    size_t index = buffer->b.load(std::memory_order_relaxed);
+    if (index >= EVENTS_PER_THREAD) {
+        buffer->c.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event& event = buffer->a[index];
+    event.a = name;
+    event.b = nowNanos();
+    event.c = phase;
+    buffer->b.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(d);
+        for (auto& buffer : e) {
+            buffer->b.store(0, std::memory_order_relaxed);
+            buffer->c.store(0, std::memory_order_relaxed);
+        }
+        f = Clock::now();
+    }
+
+    if (h.load() != this) {
+        install(this);
+    }
+    g.store(true, std::memory_order_release);
+    b.info("Trace recording started");
+}
+
+bool TraceRecorder::stop()
+{
+    if (!g.exchange(false)) return false;
+
+    size_t eventCount = 0;
+    size_t droppedCount = 0;
+    if (!writeFile(eventCount, droppedCount)) {
+        b.error("Failed to write trace file " + a);
+        return false;
+    }
+
+    b.info("Trace written to " + a + ": " + std::to_string(eventCount) + " events, " +
+        std::to_string(droppedCount) + " dropped");
+    return true;
+}
+
+void TraceRecorder::toggle()
+{
+    if (isRecording()) {
+        stop();
+    }
+    else {
+        start();
+    }
+}
+
+bool TraceRecorder::writeFile(size_t& eventCount, size_t& droppedCount)
+{
+    std::ofstream file(a, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    std::lock_guard<std::mutex> lock(d);
+    int64_t origin = std::chrono::duration_cast<std::chrono::nanoseconds>(f.time_since_epoch()).count();
+
+    std::string chunk;
+    chunk.reserve(1 << 20);
+    chunk += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    char line[256];
+    bool first = true;
+    auto appendLine = [&](int length) {
+        if (length <= 0) return;
+        if (!first) chunk += ",\n";
+        chunk.append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+        first = false;
+
+        if (chunk.size() > (1 << 20) - 512) {
+            file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            chunk.clear();
+        }
+    };
+
+    for (auto& buffer : e) {
+        appendLine(std::snprintf(line, sizeof(line),
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            buffer->d, buffer->e ? buffer->e : "thread"));
+
+        size_t count = buffer->b.load(std::memory_order_acquire);
+        for (size_t index = 0; index < count; index++) {
+            const Event& event = buffer->a[index];
+
+            // An event still in flight when the session started is from the old one
+            if (event.b < origin) continue;
+
+            appendLine(std::snprintf(line, sizeof(line),
+                "{\"name\":\"%s\",\"cat\":\"katie\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                event.a, event.c, (event.b - origin) / 1e3, buffer->d));
+            eventCount++;
+        }
+        droppedCount += buffer->c.load(std::memory_order_relaxed);
+    }
+
+    chunk += "\n]}\n";
+    file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    return file.good();
+}
\ No newline at end of file
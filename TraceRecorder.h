@@ -0,0 +1,114 @@
+// TraceRecorder.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ServerLogger;
+
+// Records begin/end events from the tick phases, network I/O and jobs, and
+// writes them as a Chrome trace (open in chrome://tracing or ui.perfetto.dev).
+//
+// Recording is off by default and toggled at runtime. While off, a trace
+// point is one relaxed load of a flag that is almost always false. Each
+// thread appends to its own fixed-size buffer, allocated when the thread
+// names itself or first records, so appending never locks or allocates;
+// once a buffer is full its thread's events are dropped and counted.
+//
+// Event names must be string literals (or otherwise outlive the recorder).
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+private:
+    struct Event {
+        const char* a; // name
+        int64_t b; // nanos - steady clock time since epoch
+        char c; // phase - 'B' begin, 'E' end
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<Event[]> a; // events
+        std::atomic<size_t> b; // count - written by the owning thread only
+        std::atomic<size_t> c; // dropped
+        int d; // threadId
+        const char* e; // threadName
+    };
+
+    std::string a; // path
+    ServerLogger& b; // logger
+    uint64_t c; // generation - tells thread-local caches apart from an earlier recorder
+
+    std::mutex d; // mutex - guards e and f
+    std::vector<std::unique_ptr<ThreadBuffer>> e; // buffers
+    Clock::time_point f; // sessionStart
+
+    static std::atomic<bool> g; // recording
+    static std::atomic<TraceRecorder*> h; // active
+    static std::atomic<uint64_t> i; // nextGeneration
+
+    ThreadBuffer* bufferForThisThread();
+    void append(const char* name, char phase);
+    bool writeFile(size_t& eventCount, size_t& droppedCount);
+
+public:
+    TraceRecorder(const std::string& path, ServerLogger& logger);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Make this the recorder trace points report to (nullptr stops and detaches)
+    static void install(TraceRecorder* recorder);
+
+    static bool isRecording() { return g.load(std::memory_order_relaxed); }
+
+    static void begin(const char* name) {
+        if (isRecording()) record(name, 'B');
+    }
+
+    static void end(const char* name) {
+        if (isRecording()) record(name, 'E');
+    }
+
+    static void record(const char* name, char phase);
+
+    // Label the calling thread in the trace and set up its buffer ahead of time
+    static void setThreadName(const char* name);
+
+    // Throw away anything recorded before and start recording
+    void start();
+    // Stop recording and write the trace file; false if it couldn't be written
+    bool stop();
+    void toggle();
+
+    const std::string& getPath() const { return a; }
+};
+
+// Begin/end event around the enclosing scope
+class TraceScope {
+private:
+    const char* a; // name
+    bool b; // recorded - whether the begin event went out
+
+public:
+    explicit TraceScope(const char* name)
+        : a(name), b(TraceRecorder::isRecording())
+    {
+        if (b) TraceRecorder::record(name, 'B');
+    }
+
+    ~TraceScope() {
+        if (b) TraceRecorder::record(a, 'E');
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
\ No newline at end of file
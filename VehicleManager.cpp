@@ -2,10 +2,11 @@
 #include "VehicleManager.h"
 #include "GameConstants.h"
 #include "VectorHelper.h"
-#include <iostream>
+#include "Log.h"
+#include "TickProfiler.h"
 
 VehicleManager::VehicleManager(sf::Vector2f initialPos, const std::vector<Planet*>& planetList, int ownerId)
-    : a(nullptr), b(nullptr), c(VehicleType::ROCKET), e(ownerId), f(0.0f)
+    : a(nullptr), b(nullptr), c(VehicleType::ROCKET), e(ownerId), f(0.0f), g(nullptr), i(0)
 {
     try {
         // First create rocket and car
@@ -20,15 +21,13 @@ VehicleManager::VehicleManager(sf::Vector2f initialPos, const std::vector<Planet
                     d.push_back(planet);
                 }
             }
-
-            // Set planets for rocket
-            if (!d.empty() && a) {
-                a->setNearbyPlanets(d);
-            }
         }
+
+        // The rocket reads d in place, so it sees every later update too
+        a->setNearbyPlanets(d);
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in VehicleManager constructor: " << ex.what() << std::endl;
+        KLOG_ERROR(VEHICLE, "exception", "where", "VehicleManager", "owner", e, "error", ex.what());
 
         // Make sure objects are created
         try {
@@ -36,42 +35,55 @@ VehicleManager::VehicleManager(sf::Vector2f initialPos, const std::vector<Planet
             if (!b) b = std::make_unique<Car>(initialPos, sf::Vector2f(0, 0));
         }
         catch (const std::exception& ex2) {
-            std::cerr << "Failed to create vehicles: " << ex2.what() << std::endl;
+            KLOG_ERROR(VEHICLE, "exception", "where", "createVehicles", "owner", e, "error", ex2.what());
         }
 
         // Clear problematic planets
         d.clear();
+        if (a) a->setNearbyPlanets(d);
     }
 }
 
 void VehicleManager::switchVehicle()
 {
     if (!a || !b) {
-        std::cerr << "Error: Missing vehicle in switchVehicle" << std::endl;
+        KLOG_ERROR(VEHICLE, "missing_vehicle", "where", "switchVehicle", "owner", e);
         return;
     }
 
-    if (d.empty()) {
+    if (d.empty() && (!g || g->size() == 0)) {
         return; // Can't switch without planets
     }
 
     if (c == VehicleType::ROCKET) {
         // Check if near a planet
         bool canSwitch = false;
-        for (const auto& planet : d) {
-            if (!planet) continue;
+        if (g) {
+            canSwitch = g->nearest(a->getPosition(), GameConstants::TRANSFORM_DISTANCE) != nullptr;
+        }
+        else {
+            for (const auto& planet : d) {
+                if (!planet) continue;
 
-            float dist = distance(a->getPosition(), planet->getPosition());
-            if (dist <= planet->getRadius() + GameConstants::TRANSFORM_DISTANCE) {
-                canSwitch = true;
-                break;
+                float dist = distance(a->getPosition(), planet->getPosition());
+                if (dist <= planet->getRadius() + GameConstants::TRANSFORM_DISTANCE) {
+                    canSwitch = true;
+                    break;
+                }
             }
         }
 
         if (canSwitch) {
             // Transfer rocket state to car
             b->initializeFromRocket(a.get());
-            b->checkGrounding(d);
+            if (g) {
+                h.clear();
+                g->queryRadius(a->getPosition(), GameConstants::TRANSFORM_DISTANCE, h);
+                b->checkGrounding(h);
+            }
+            else {
+                b->checkGrounding(d);
+            }
             c = VehicleType::CAR;
         }
     }
@@ -88,25 +100,37 @@ void VehicleManager::switchVehicle()
 
 void VehicleManager::update(float deltaTime)
 {
-    // Update with safety checks
-    if (d.empty()) {
-        // Still update the active vehicle
-        if (c == VehicleType::ROCKET) {
-            if (a) a->update(deltaTime);
+    ProfileScope profile(ProfilePhase::VEHICLE_UPDATE);
+
+    // With a shared index, only the planets the vehicle can reach this tick are
+    // fetched, into the list the rocket already points at
+    if (g) {
+        GameObject* vehicle = getActiveVehicle();
+        if (!vehicle) return;
+
+        sf::Vector2f velocity = vehicle->getVelocity();
+        float travel = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y) * deltaTime;
+        h.clear();
+        g->queryRadius(vehicle->getPosition(), GameConstants::ROCKET_SIZE + GameConstants::ROCKET_CONTACT_SKIN + travel, h);
+
+        try {
+            if (c == VehicleType::ROCKET) {
+                a->update(deltaTime);
+                f = a->getLastStateTimestamp();
+            }
+            else {
+                b->checkGrounding(h);
+                b->update(deltaTime);
+            }
         }
-        else {
-            if (b) b->update(deltaTime);
+        catch (const std::exception& ex) {
+            KLOG_ERROR(VEHICLE, "exception", "where", "vehicleUpdate", "owner", e, "error", ex.what());
         }
         return;
     }
 
-    // Create safe list of valid planets
-    std::vector<Planet*> validPlanets;
-    for (auto* planet : d) {
-        if (planet) validPlanets.push_back(planet);
-    }
-
-    if (validPlanets.empty()) {
+    // Update with safety checks
+    if (d.empty()) {
         // Still update the active vehicle
         if (c == VehicleType::ROCKET) {
             if (a) a->update(deltaTime);
@@ -117,28 +141,27 @@ void VehicleManager::update(float deltaTime)
         return;
     }
 
-    // Update with valid planets
+    // d holds no nulls and the rocket already points at it, so nothing is copied per tick
     if (c == VehicleType::ROCKET) {
         if (a) {
             try {
-                a->setNearbyPlanets(validPlanets);
                 a->update(deltaTime);
                 // Update timestamp after successful update
                 f = a->getLastStateTimestamp();
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception in rocket update: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "rocketUpdate", "owner", e, "error", ex.what());
             }
         }
     }
     else {
         if (b) {
             try {
-                b->checkGrounding(validPlanets);
+                b->checkGrounding(d);
                 b->update(deltaTime);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception in car update: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "carUpdate", "owner", e, "error", ex.what());
             }
         }
     }
@@ -154,7 +177,7 @@ void VehicleManager::draw(sf::RenderWindow& window)
                 a->draw(window);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception drawing rocket: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "drawRocket", "error", ex.what());
             }
         }
     }
@@ -164,7 +187,7 @@ void VehicleManager::draw(sf::RenderWindow& window)
                 b->draw(window);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception drawing car: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "drawCar", "error", ex.what());
             }
         }
     }
@@ -176,7 +199,7 @@ void VehicleManager::drawWithConstantSize(sf::RenderWindow& window, float zoomLe
 
     if (c == VehicleType::ROCKET) {
         if (!a) {
-            std::cerr << "Warning: Null rocket in drawWithConstantSize" << std::endl;
+            KLOG_WARN(VEHICLE, "missing_vehicle", "where", "drawWithConstantSize", "vehicle", "rocket");
             return;
         }
 
@@ -184,12 +207,12 @@ void VehicleManager::drawWithConstantSize(sf::RenderWindow& window, float zoomLe
             a->drawWithConstantSize(window, zoomLevel);
         }
         catch (const std::exception& ex) {
-            std::cerr << "Exception drawing rocket: " << ex.what() << std::endl;
+            KLOG_ERROR(VEHICLE, "exception", "where", "drawRocket", "error", ex.what());
         }
     }
     else {
         if (!b) {
-            std::cerr << "Warning: Null car in drawWithConstantSize" << std::endl;
+            KLOG_WARN(VEHICLE, "missing_vehicle", "where", "drawWithConstantSize", "vehicle", "car");
             return;
         }
 
@@ -197,7 +220,7 @@ void VehicleManager::drawWithConstantSize(sf::RenderWindow& window, float zoomLe
             b->drawWithConstantSize(window, zoomLevel);
         }
         catch (const std::exception& ex) {
-            std::cerr << "Exception drawing car: " << ex.what() << std::endl;
+            KLOG_ERROR(VEHICLE, "exception", "where", "drawCar", "error", ex.what());
         }
     }
 }
@@ -210,7 +233,7 @@ void VehicleManager::applyThrust(float amount)
                 a->applyThrust(amount);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception applying thrust: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "applyThrust", "owner", e, "error", ex.what());
             }
         }
     }
@@ -220,7 +243,7 @@ void VehicleManager::applyThrust(float amount)
                 b->accelerate(amount);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception accelerating car: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "accelerateCar", "owner", e, "error", ex.what());
             }
         }
     }
@@ -234,7 +257,7 @@ void VehicleManager::rotate(float amount)
                 a->rotate(amount);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception rotating rocket: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "rotateRocket", "owner", e, "error", ex.what());
             }
         }
     }
@@ -244,12 +267,36 @@ void VehicleManager::rotate(float amount)
                 b->rotate(amount);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception rotating car: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "rotateCar", "owner", e, "error", ex.what());
             }
         }
     }
 }
 
+void VehicleManager::applyInput(const PlayerInput& input)
+{
+    if (input.b) {
+        applyThrust(1.0f);
+    }
+    if (input.c) {
+        applyThrust(-0.5f);
+    }
+    if (input.d) {
+        rotate(-6.0f * input.h * 60.0f);
+    }
+    if (input.e) {
+        rotate(6.0f * input.h * 60.0f);
+    }
+    if (input.f) {
+        switchVehicle();
+    }
+
+    // Apply thrust level with safe null checking
+    if (c == VehicleType::ROCKET && a) {
+        a->setThrustLevel(input.g);
+    }
+}
+
 void VehicleManager::drawVelocityVector(sf::RenderWindow& window, float scale)
 {
     if (!window.isOpen()) return;
@@ -260,7 +307,7 @@ void VehicleManager::drawVelocityVector(sf::RenderWindow& window, float scale)
                 a->drawVelocityVector(window, scale);
             }
             catch (const std::exception& ex) {
-                std::cerr << "Exception drawing velocity vector: " << ex.what() << std::endl;
+                KLOG_ERROR(VEHICLE, "exception", "where", "drawVelocityVector", "error", ex.what());
             }
         }
     }
@@ -277,11 +324,15 @@ GameObject* VehicleManager::getActiveVehicle()
     }
 }
 
-void VehicleManager::updatePlanets(const std::vector<Planet*>& newPlanets)
+void VehicleManager::updatePlanets(const std::vector<Planet*>& newPlanets, unsigned long version)
 {
+    // With an index the list is never read, so don't copy it
+    if (g || version == i) return;
+
     try {
         // Clear current planets first
         d.clear();
+        i = version;
 
         // Copy valid planets
         for (auto* planet : newPlanets) {
@@ -290,18 +341,21 @@ void VehicleManager::updatePlanets(const std::vector<Planet*>& newPlanets)
             }
         }
 
-        // Update rocket's planets
-        if (a) {
-            a->setNearbyPlanets(d);
-        }
-
         // Update car's planets if needed
         if (b) {
             b->checkGrounding(d);
         }
     }
     catch (const std::exception& ex) {
-        std::cerr << "Exception in updatePlanets: " << ex.what() << std::endl;
+        KLOG_ERROR(VEHICLE, "exception", "where", "updatePlanets", "owner", e, "error", ex.what());
+    }
+}
+
+void VehicleManager::setPlanetIndex(const PlanetIndex* index)
+{
+    g = index;
+    if (a) {
+        a->setNearbyPlanets(g ? h : d);
     }
 }
 
@@ -317,7 +371,7 @@ void VehicleManager::createState(RocketState& state) const
         state.d = a->getRotation();
 
         // Set other rocket properties
-        state.e = 0.0f; // Angular velocity not tracked directly
+        state.e = a->getAngularVelocity();
         state.f = a->getThrustLevel();
         state.g = a->getMass();
         state.h = a->getColor();
@@ -3,6 +3,8 @@
 #include "Rocket.h"
 #include "Car.h"
 #include "Planet.h"
+#include "PlayerInput.h"
+#include "PlanetIndex.h"
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <memory>
 #include <vector>
@@ -17,9 +19,12 @@ private:
     std::unique_ptr<Rocket> a; // rocket
     std::unique_ptr<Car> b; // car
     VehicleType c; // activeVehicle
-    std::vector<Planet*> d; // planets
+    std::vector<Planet*> d; // planets - never holds nulls; the rocket and car read it in place
     int e; // ownerId - which player owns this vehicle manager
     float f; // lastStateTimestamp - when the vehicle state was last updated
+    const PlanetIndex* g; // planetIndex - shared index queried instead of d when set
+    std::vector<Planet*> h; // nearbyPlanets - index query results, refilled each tick without reallocating
+    unsigned long i; // planetVersion - version of the planet list d was copied from (0 before the first copy)
 
 public:
     VehicleManager(sf::Vector2f initialPos, const std::vector<Planet*>& planetList, int ownerId = -1);
@@ -32,6 +37,9 @@ public:
     // Pass through functions to active vehicle
     void applyThrust(float amount);
     void rotate(float amount);
+
+    // Apply a player's input - shared by the server and client prediction so both agree
+    void applyInput(const PlayerInput& input);
     void drawVelocityVector(sf::RenderWindow& window, float scale = 1.0f);
 
     // Ownership methods
@@ -50,8 +58,13 @@ public:
     GameObject* getActiveVehicle();
     VehicleType getActiveVehicleType() const { return c; }
 
-    // Add method to update planet references
-    void updatePlanets(const std::vector<Planet*>& newPlanets);
+    // Copy the planet list if its version differs from the one already held,
+    // so callers can offer it every tick and pay only when planets change
+    void updatePlanets(const std::vector<Planet*>& newPlanets, unsigned long version);
+
+    // Query a shared planet index instead of keeping a planet list; the index
+    // must outlive this manager and be rebuilt by its owner as planets move
+    void setPlanetIndex(const PlanetIndex* index);
 
     // Create state for serialization
     void createState(RocketState& state) const;
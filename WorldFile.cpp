@@ -0,0 +1,276 @@
+// WorldFile.cpp
+#include "WorldFile.h"
+#include "TraceRecorder.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char MAGIC[4] = { 'K', 'W', 'L', 'D' };
+
+    uint64_t checksumBytes(const char* bytes, size_t count, uint64_t hash = 14695981039346656037ull) {
+        for (size_t i = 0; i < count; i++) {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool replaceFile(const std::string& from, const std::string& to) {
+#if defined(_WIN32)
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+}
+
+namespace WorldFile {
+    size_t save(const std::string& path, const WorldSnapshot& snapshot)
+    {
+        const char* planetBytes = reinterpret_cast<const char*>(snapshot.planets.data());
+        const char* playerBytes = reinterpret_cast<const char*>(snapshot.players.data());
+        size_t planetSize = snapshot.planets.size() * sizeof(WorldPlanetRecord);
+        size_t playerSize = snapshot.players.size() * sizeof(WorldPlayerRecord);
+
+        WorldFileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.headerBytes = sizeof(WorldFileHeader);
+        header.planetRecordBytes = sizeof(WorldPlanetRecord);
+        header.playerRecordBytes = sizeof(WorldPlayerRecord);
+        header.planetCount = static_cast<uint32_t>(snapshot.planets.size());
+        header.planetOffset = sizeof(WorldFileHeader);
+        header.playerCount = static_cast<uint32_t>(snapshot.players.size());
+        header.playerOffset = static_cast<uint32_t>(header.planetOffset + planetSize);
+        header.gameTime = snapshot.gameTime;
+        header.sequenceNumber = snapshot.sequenceNumber;
+        header.checksum = checksumBytes(playerBytes, playerSize, checksumBytes(planetBytes, planetSize));
+
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) return 0;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(planetBytes, static_cast<std::streamsize>(planetSize));
+            file.write(playerBytes, static_cast<std::streamsize>(playerSize));
+            file.flush();
+            if (!file) return 0;
+        }
+
+        if (!replaceFile(temporary, path)) return 0;
+        return sizeof(header) + planetSize + playerSize;
+    }
+}
+
+MappedWorld::MappedWorld()
+    : a(nullptr), b(0)
+#if defined(_WIN32)
+    , c(INVALID_HANDLE_VALUE), d(nullptr)
+#endif
+{
+}
+
+MappedWorld::~MappedWorld()
+{
+    close();
+}
+
+bool MappedWorld::open(const std::string& path)
+{
+    close();
+
+#if defined(_WIN32)
+    c = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (c == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(c, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(WorldFileHeader))) {
+        close();
+        return false;
+    }
+
+    d = CreateFileMappingA(c, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!d) {
+        close();
+        return false;
+    }
+
+    a = static_cast<const char*>(MapViewOfFile(d, FILE_MAP_READ, 0, 0, 0));
+    b = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(WorldFileHeader))) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file alive; the descriptor isn't needed after this
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    a = static_cast<const char*>(mapped);
+    b = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!a || !validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedWorld::close()
+{
+#if defined(_WIN32)
+    if (a) UnmapViewOfFile(a);
+    if (d) CloseHandle(d);
+    if (c != INVALID_HANDLE_VALUE) CloseHandle(c);
+    d = nullptr;
+    c = INVALID_HANDLE_VALUE;
+#else
+    if (a) munmap(const_cast<char*>(a), b);
+#endif
+    a = nullptr;
+    b = 0;
+}
+
+bool MappedWorld::validate() const
+{
+    const WorldFileHeader& h = header();
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != WorldFile::VERSION) return false;
+    if (h.headerBytes != sizeof(WorldFileHeader) ||
+        h.planetRecordBytes != sizeof(WorldPlanetRecord) ||
+        h.playerRecordBytes != sizeof(WorldPlayerRecord)) return false;
+
+    // Arrays must be aligned for their records and lie inside the file
+    uint64_t planetEnd = static_cast<uint64_t>(h.planetOffset) + static_cast<uint64_t>(h.planetCount) * sizeof(WorldPlanetRecord);
+    uint64_t playerEnd = static_cast<uint64_t>(h.playerOffset) + static_cast<uint64_t>(h.playerCount) * sizeof(WorldPlayerRecord);
+    if (h.planetOffset < sizeof(WorldFileHeader) || h.planetOffset % 8 != 0 || planetEnd > b) return false;
+    if (h.playerOffset < sizeof(WorldFileHeader) || h.playerOffset % 8 != 0 || playerEnd > b) return false;
+
+    return checksumBytes(a + sizeof(WorldFileHeader), b - sizeof(WorldFileHeader)) == h.checksum;
+}
+
+WorldCheckpointer::WorldCheckpointer(const std::string& path, ServerLogger& logger)
+    : a(logger), b(path), f(false), i(false),
+    j(0), k(0), l(0)
+{
+}
+
+WorldCheckpointer::~WorldCheckpointer()
+{
+    stop();
+}
+
+void WorldCheckpointer::start()
+{
+    std::lock_guard<std::mutex> lock(d);
+    if (f) return;
+
+    f = true;
+    c = std::thread(&WorldCheckpointer::run, this);
+}
+
+void WorldCheckpointer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d);
+        if (!f) return;
+        f = false;
+    }
+    e.notify_one();
+
+    if (c.joinable()) {
+        c.join();
+    }
+}
+
+void WorldCheckpointer::submit(WorldSnapshot& snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(d);
+        if (i) {
+            k++;
+        }
+        std::swap(g, snapshot);
+        i = true;
+    }
+    e.notify_one();
+}
+
+void WorldCheckpointer::run()
+{
+    TraceRecorder::setThreadName("checkpoint writer");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(d);
+            e.wait(lock, [this]() { return i || !f; });
+
+            // Write the last checkpoint before shutting down
+            if (!i) break;
+
+            std::swap(h, g);
+            i = false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t bytes;
+        {
+            TraceScope trace("world_checkpoint");
+            bytes = WorldFile::save(b, h);
+        }
+        float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(d);
+            if (bytes > 0) j++;
+            else l++;
+        }
+
+        if (bytes > 0) {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << "World checkpoint at tick " << h.sequenceNumber
+                << ": " << h.planets.size() << " planets, " << h.players.size() << " players, "
+                << bytes << " bytes in " << milliseconds << "ms";
+            a.debug(ss.str());
+        }
+        else {
+            a.warning("Failed to write world checkpoint " + b);
+        }
+    }
+}
+
+unsigned long WorldCheckpointer::getWrittenCount()
+{
+    std::lock_guard<std::mutex> lock(d);
+    return j;
+}
+
+unsigned long WorldCheckpointer::getSupersededCount()
+{
+    std::lock_guard<std::mutex> lock(d);
+    return k;
+}
\ No newline at end of file
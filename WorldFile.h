@@ -0,0 +1,155 @@
+// WorldFile.h
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include "ServerLogger.h"
+
+// On-disk world layout: a fixed header followed by two arrays of fixed-size
+// records. Every field is 4 or 8 bytes and every array starts on an 8-byte
+// boundary, so a mapped file is used in place - the loader checks the header
+// and hands out pointers, with no per-field parsing. Values are stored in the
+// host's byte order (little-endian on every platform the server ships on).
+struct WorldFileHeader {
+    char magic[4];              // "KWLD"
+    uint32_t version;
+    uint32_t headerBytes;       // sizeof(WorldFileHeader) of the writer
+    uint32_t planetRecordBytes;
+    uint32_t playerRecordBytes;
+    uint32_t planetCount;
+    uint32_t planetOffset;      // from the start of the file
+    uint32_t playerCount;
+    uint32_t playerOffset;
+    float gameTime;
+    uint64_t sequenceNumber;
+    uint64_t checksum;          // FNV-1a of everything after the header
+};
+
+struct WorldPlanetRecord {
+    float positionX;
+    float positionY;
+    float velocityX;
+    float velocityY;
+    float mass;
+    float radius;
+    int32_t ownerId;
+    uint32_t color;             // sf::Color::toInteger
+};
+
+// A player's rocket. Connection state isn't saved: a record is handed back
+// when a client with the same id joins the restored world
+struct WorldPlayerRecord {
+    int32_t playerId;
+    float positionX;
+    float positionY;
+    float velocityX;
+    float velocityY;
+    float rotation;
+    float angularVelocity;
+    float thrustLevel;
+    float mass;
+    float storedMass;
+    float timestamp;
+    uint32_t color;
+};
+
+static_assert(std::is_trivially_copyable<WorldFileHeader>::value && sizeof(WorldFileHeader) == 56, "world header layout");
+static_assert(std::is_trivially_copyable<WorldPlanetRecord>::value && sizeof(WorldPlanetRecord) == 32, "world planet layout");
+static_assert(std::is_trivially_copyable<WorldPlayerRecord>::value && sizeof(WorldPlayerRecord) == 48, "world player layout");
+
+// Flat copy of the world taken on the tick thread, ready to be written as is
+struct WorldSnapshot {
+    uint64_t sequenceNumber = 0;
+    float gameTime = 0.0f;
+    std::vector<WorldPlanetRecord> planets;
+    std::vector<WorldPlayerRecord> players;
+};
+
+namespace WorldFile {
+    constexpr uint32_t VERSION = 1;
+
+    // Write to path.tmp and move it over path, so a crash mid-write leaves the
+    // previous file intact. Returns the bytes written, 0 on failure
+    size_t save(const std::string& path, const WorldSnapshot& snapshot);
+}
+
+// A world file mapped read-only into memory. The record arrays point straight
+// into the mapping and stay valid until the MappedWorld is closed
+class MappedWorld {
+private:
+    const char* a; // data - the mapped file, nullptr when closed
+    size_t b; // size
+#if defined(_WIN32)
+    void* c; // fileHandle
+    void* d; // mappingHandle
+#endif
+
+public:
+    MappedWorld();
+    ~MappedWorld();
+
+    MappedWorld(const MappedWorld&) = delete;
+    MappedWorld& operator=(const MappedWorld&) = delete;
+
+    // Map a file and check its header, bounds and checksum; false leaves it closed
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return a != nullptr; }
+
+    const WorldFileHeader& header() const { return *reinterpret_cast<const WorldFileHeader*>(a); }
+    const WorldPlanetRecord* planets() const { return reinterpret_cast<const WorldPlanetRecord*>(a + header().planetOffset); }
+    const WorldPlayerRecord* players() const { return reinterpret_cast<const WorldPlayerRecord*>(a + header().playerOffset); }
+    size_t planetCount() const { return header().planetCount; }
+    size_t playerCount() const { return header().playerCount; }
+    size_t byteSize() const { return b; }
+
+private:
+    bool validate() const;
+};
+
+// Writes world checkpoints on a background thread so the tick never waits for
+// the disk. Works like SnapshotPipeline: the tick thread swaps a filled
+// snapshot into the pending slot and gets the previous buffer back to refill,
+// so after warm-up nothing is allocated. A checkpoint still pending when a
+// newer one arrives is dropped.
+class WorldCheckpointer {
+private:
+    ServerLogger& a; // logger
+    std::string b; // path
+
+    std::thread c; // worker
+    std::mutex d; // mutex
+    std::condition_variable e; // wakeUp
+    bool f; // running
+
+    WorldSnapshot g; // pending
+    WorldSnapshot h; // writing - owned by the worker while it writes
+    bool i; // hasPending
+
+    unsigned long j; // written
+    unsigned long k; // superseded
+    unsigned long l; // failed
+
+    void run();
+
+public:
+    WorldCheckpointer(const std::string& path, ServerLogger& logger);
+    ~WorldCheckpointer();
+
+    void start();
+
+    // Write whatever is still pending, then join the worker
+    void stop();
+
+    // Hand over a snapshot to be written; snapshot comes back holding an older
+    // buffer whose contents are unspecified
+    void submit(WorldSnapshot& snapshot);
+
+    unsigned long getWrittenCount();
+    unsigned long getSupersededCount();
+};
\ No newline at end of file
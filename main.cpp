@@ -3,6 +3,8 @@
 #include <chrono>
 #include <thread>
 #include <csignal>
+#include <sstream>
+#include <algorithm>
 #include <SFML/Network.hpp>
 #include "ServerLogger.h"
 #include "ServerConfig.h"
@@ -11,6 +13,17 @@
 #include "GameServer.h"
 #include "GameState.h"
 #include "PlayerInput.h"
+#include "TickScheduler.h"
+#include "SnapshotPipeline.h"
+#include "RoomManager.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "TickProfiler.h"
+#include "MetricsServer.h"
+#include "TraceRecorder.h"
+#include "ReplayLog.h"
+#include "WorldFile.h"
+#include "VectorHelper.h"
 
 #ifdef _DEBUG
 #pragma comment(lib, "sfml-system-d.lib")
@@ -27,12 +40,27 @@
 // Global flag for graceful shutdown
 volatile bool running = true;
 
+// Set by SIGUSR1; the server loop starts or stops trace recording
+volatile std::sig_atomic_t traceToggleRequested = 0;
+
 // Signal handler for graceful shutdown
 void signalHandler(int signal) {
     std::cout << "Caught signal " << signal << ", shutting down..." << std::endl;
     running = false;
 }
 
+void traceSignalHandler(int) {
+    traceToggleRequested = 1;
+}
+
+// Handle a pending SIGUSR1 from the server loop, where writing the file is safe
+void pollTraceToggle(TraceRecorder& tracer) {
+    if (traceToggleRequested) {
+        traceToggleRequested = 0;
+        tracer.toggle();
+    }
+}
+
 // Parse command line arguments
 void parseCommandLine(int argc, char* argv[], ServerConfig& config) {
     for (int i = 1; i < argc; i++) {
@@ -47,12 +75,57 @@ void parseCommandLine(int argc, char* argv[], ServerConfig& config) {
         else if (arg == "--update-rate" && i + 1 < argc) {
             config.setUpdateRate(std::stof(argv[++i]));
         }
+        else if (arg == "--max-catch-up" && i + 1 < argc) {
+            config.setMaxCatchUpSteps(std::stoi(argv[++i]));
+        }
+        else if (arg == "--rooms" && i + 1 < argc) {
+            config.setRoomCount(std::stoi(argv[++i]));
+        }
+        else if (arg == "--room-workers" && i + 1 < argc) {
+            config.setRoomWorkers(std::stoi(argv[++i]));
+        }
+        else if (arg == "--job-threads" && i + 1 < argc) {
+            config.setJobThreads(std::stoi(argv[++i]));
+        }
+        else if (arg == "--no-profile") {
+            config.setProfiling(false);
+        }
+        else if (arg == "--metrics-port" && i + 1 < argc) {
+            config.setMetricsPort(static_cast<unsigned short>(std::stoi(argv[++i])));
+        }
+        else if (arg == "--trace-file" && i + 1 < argc) {
+            config.setTraceFile(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            config.setRecordFile(argv[++i]);
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            config.setReplayFile(argv[++i]);
+        }
+        else if (arg == "--keyframe-ticks" && i + 1 < argc) {
+            config.setKeyframeInterval(std::max(1, std::stoi(argv[++i])));
+        }
+        else if (arg == "--world" && i + 1 < argc) {
+            config.setWorldFile(argv[++i]);
+        }
+        else if (arg == "--checkpoint-seconds" && i + 1 < argc) {
+            config.setCheckpointInterval(std::max(0.0f, std::stof(argv[++i])));
+        }
+        else if (arg == "--deterministic") {
+            config.setDeterministic(true);
+        }
+        else if (arg == "--serial-broadcast") {
+            config.setPipelinedBroadcast(false);
+        }
         else if (arg == "--quiet") {
             config.setVerbose(false);
         }
         else if (arg == "--log" && i + 1 < argc) {
             config.setLogFile(argv[++i]);
         }
+        else if (arg == "--log-level" && i + 1 < argc) {
+            config.setLogLevel(argv[++i]);
+        }
         else if (arg == "--help") {
             std::cout << "KatieServer - Standalone Game Server" << std::endl;
             std::cout << "Usage: KatieServer [options]" << std::endl;
@@ -60,18 +133,225 @@ void parseCommandLine(int argc, char* argv[], ServerConfig& config) {
             std::cout << "  --port PORT          Set server port (default: 5000)" << std::endl;
             std::cout << "  --max-clients NUM    Set maximum number of clients (default: 16)" << std::endl;
             std::cout << "  --update-rate RATE   Set update rate in seconds (default: 0.05)" << std::endl;
+            std::cout << "  --max-catch-up NUM   Most simulation steps per frame when behind (default: 5)" << std::endl;
+            std::cout << "  --job-threads NUM    Extra threads for the tick's parallel loops (default: one per spare core, 0 = serial)" << std::endl;
+            std::cout << "  --serial-broadcast   Send snapshots on the tick thread instead of a worker" << std::endl;
+            std::cout << "  --rooms NUM          Host NUM independent rooms (default: 1)" << std::endl;
+            std::cout << "  --room-workers NUM   Threads ticking the rooms (default: one per spare core)" << std::endl;
+            std::cout << "  --no-profile         Turn off the per-phase tick profiler" << std::endl;
+            std::cout << "  --metrics-port PORT  Serve Prometheus metrics on 127.0.0.1:PORT/metrics (default: off)" << std::endl;
+            std::cout << "  --trace-file FILE    Where a trace recording is written (default: server_trace.json)." << std::endl;
+            std::cout << "                       Toggle recording with SIGUSR1 or GET /trace/start and /trace/stop" << std::endl;
+            std::cout << "  --record FILE        Record inputs, joins, leaves and keyframes for replay" << std::endl;
+            std::cout << "  --keyframe-ticks NUM Ticks between recorded keyframes (default: 100)" << std::endl;
+            std::cout << "  --replay FILE        Re-simulate a recording headlessly as fast as possible and check its keyframes" << std::endl;
+            std::cout << "  --world FILE         Start from the world saved in FILE and checkpoint to it (default: off)" << std::endl;
+            std::cout << "  --checkpoint-seconds SEC Seconds between world checkpoints, 0 = only at shutdown (default: 30)" << std::endl;
+            std::cout << "  --deterministic      Stamp every snapshot with a hash of the exact simulation state" << std::endl;
             std::cout << "  --quiet              Disable verbose logging" << std::endl;
             std::cout << "  --log FILE           Specify log file path" << std::endl;
+            std::cout << "  --log-level LEVEL    debug, info, warning or error (default: info)" << std::endl;
             std::cout << "  --help               Display this help message" << std::endl;
             exit(0);
         }
     }
 }
 
+// Multi-room hosting: rooms tick on their own workers, this thread only does network I/O
+int runRooms(ServerConfig& config, ServerLogger& logger, ClientManager& clientManager, NetworkManager& networkManager,
+    TickProfiler& profiler, MetricsServer& metrics, TraceRecorder& tracer) {
+    RoomManager roomManager(networkManager, logger, config);
+    roomManager.start();
+
+    if (!networkManager.start()) {
+        logger.error("Failed to start network manager, exiting...");
+        roomManager.stop();
+        return 1;
+    }
+
+    logger.info("Server started successfully!");
+
+    auto lastStatusTime = std::chrono::steady_clock::now();
+
+    // Rooms keep their own tick; this loop only bounds input latency. It wakes
+    // on absolute deadlines like the TickScheduler, so the wait neither drifts
+    // nor rounds up to the OS sleep quantum
+    const auto pollInterval = std::chrono::duration_cast<TickScheduler::Clock::duration>(
+        std::chrono::duration<float>(config.getUpdateRate() / GameConstants::ROOM_NETWORK_POLLS_PER_TICK));
+    auto nextPoll = TickScheduler::Clock::now();
+
+    while (running) {
+        // Accept connections and route client messages to their rooms
+        networkManager.update();
+        metrics.poll();
+        pollTraceToggle(tracer);
+
+        // Periodically log status (every 10 seconds)
+        auto currentTime = std::chrono::steady_clock::now();
+        auto statusDuration = std::chrono::duration_cast<std::chrono::seconds>(currentTime - lastStatusTime).count();
+        if (statusDuration >= 10) {
+            clientManager.logClientInfo();
+            roomManager.logStats();
+            if (config.isProfiling()) {
+                profiler.logStats(logger);
+            }
+            lastStatusTime = currentTime;
+        }
+
+        // After a stall, start again from now rather than polling in a burst
+        nextPoll += pollInterval;
+        auto now = TickScheduler::Clock::now();
+        if (nextPoll < now) {
+            nextPoll = now;
+        }
+        TickScheduler::sleepUntil(nextPoll);
+    }
+
+    logger.info("Server shutting down...");
+    roomManager.stop();
+    networkManager.stop();
+
+    return 0;
+}
+
+// Largest position difference between a keyframe and the re-simulated state
+// (rockets matched by player, planets by index); -1 if the bodies don't match up
+float keyframeDivergence(const GameState& recorded, const GameState& replayed) {
+    if (recorded.c.size() != replayed.c.size() || recorded.d.size() != replayed.d.size()) return -1.0f;
+
+    float worst = 0.0f;
+    for (const RocketState& expected : recorded.c) {
+        auto actual = std::find_if(replayed.c.begin(), replayed.c.end(),
+            [&expected](const RocketState& rocket) { return rocket.a == expected.a; });
+        if (actual == replayed.c.end()) return -1.0f;
+        worst = std::max(worst, distance(expected.b, actual->b));
+    }
+    for (size_t i = 0; i < recorded.d.size(); i++) {
+        worst = std::max(worst, distance(recorded.d[i].b, replayed.d[i].b));
+    }
+    return worst;
+}
+
+// Re-drive a GameServer from a recording with no network and no pacing.
+// Returns non-zero if a keyframe didn't match, so it can gate physics changes
+int runReplay(ServerConfig& config, ServerLogger& logger) {
+    ReplayReader reader;
+    if (!reader.open(config.getReplayFile())) {
+        logger.error("Cannot read replay " + config.getReplayFile());
+        return 1;
+    }
+
+    config.setUpdateRate(reader.getTickSeconds());
+
+    // Hash every keyframe so recordings made in deterministic mode are checked bit for bit
+    config.setDeterministic(true);
+    GameServer gameServer(logger, config);
+    gameServer.initialize();
+
+    unsigned int jobThreads = config.getJobThreads() >= 0 ?
+        static_cast<unsigned int>(config.getJobThreads()) : JobSystem::defaultThreadCount();
+    JobSystem jobs(jobThreads);
+    gameServer.setJobSystem(&jobs);
+
+    const float tolerance = 0.01f;
+    unsigned long ticks = 0;
+    unsigned long inputs = 0;
+    unsigned long keyframes = 0;
+    unsigned long mismatches = 0;
+    float worstDivergence = 0.0f;
+
+    ReplayRecordType type;
+    sf::Packet payload;
+    auto start = std::chrono::steady_clock::now();
+
+    while (running && reader.next(type, payload)) {
+        switch (type) {
+        case ReplayRecordType::TICK:
+        {
+            float deltaTime = 0.0f;
+            if (payload >> deltaTime) {
+                gameServer.update(deltaTime);
+                ticks++;
+            }
+            break;
+        }
+        case ReplayRecordType::CONNECT:
+        {
+            int32_t clientId = 0;
+            sf::Vector2f spawn;
+            if (payload >> clientId >> spawn) {
+                gameServer.addPlayer(clientId, spawn, sf::Color::Red);
+            }
+            break;
+        }
+        case ReplayRecordType::DISCONNECT:
+        {
+            int32_t clientId = 0;
+            if (payload >> clientId) {
+                gameServer.handlePlayerDisconnect(clientId);
+            }
+            break;
+        }
+        case ReplayRecordType::INPUT:
+        {
+            int32_t clientId = 0;
+            PlayerInput input;
+            if (payload >> clientId >> input) {
+                gameServer.handlePlayerInput(clientId, input);
+                inputs++;
+            }
+            break;
+        }
+        case ReplayRecordType::KEYFRAME:
+        {
+            GameState recorded;
+            if (!(payload >> recorded)) break;
+
+            GameState replayed = gameServer.getGameState();
+            float divergence = keyframeDivergence(recorded, replayed);
+            keyframes++;
+            if (divergence < 0.0f || divergence > tolerance) {
+                mismatches++;
+                logger.warning("Keyframe at tick " + std::to_string(ticks) + " diverged by " +
+                    (divergence < 0.0f ? std::string("a different set of bodies") : std::to_string(divergence)));
+            }
+            else if (recorded.f != 0 && recorded.f != replayed.f) {
+                // Within tolerance, but not the same bits
+                mismatches++;
+                logger.warning("Keyframe at tick " + std::to_string(ticks) + " state hash differs");
+            }
+            worstDivergence = std::max(worstDivergence, divergence);
+            break;
+        }
+        default:
+            logger.warning("Skipping unknown replay record " + std::to_string(static_cast<int>(type)));
+            break;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::stringstream ss;
+    ss << "Replayed " << ticks << " ticks and " << inputs << " inputs in " << seconds << "s ("
+        << (seconds > 0.0 ? ticks / seconds : 0.0) << " ticks/s, "
+        << (seconds > 0.0 ? ticks * config.getUpdateRate() / seconds : 0.0) << "x real time); "
+        << keyframes << " keyframes, " << mismatches << " diverged, worst " << worstDivergence;
+    if (mismatches > 0) {
+        logger.warning(ss.str());
+    }
+    else {
+        logger.info(ss.str());
+    }
+
+    return mismatches > 0 ? 2 : 0;
+}
+
 int main(int argc, char* argv[]) {
     // Configure signal handlers for graceful shutdown
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+#ifdef SIGUSR1
+    signal(SIGUSR1, traceSignalHandler);
+#endif
 
     // Initialize configuration with defaults
     ServerConfig config;
@@ -79,31 +359,125 @@ int main(int argc, char* argv[]) {
 
     // Initialize logger
     ServerLogger logger(config.getLogFile(), config.isVerbose());
+    logger.setMinLevel(ServerLogger::parseLevel(config.getLogLevel()));
+    Log::ScopedSink logSink(logger);
+
+    // Per-phase tick histograms, dumped with the periodic status
+    TickProfiler profiler;
+    profiler.setBudget(ProfilePhase::TICK, config.getUpdateRate());
+    if (config.isProfiling()) {
+        TickProfiler::install(&profiler);
+    }
+
+    // Detailed event trace, off until toggled; declared before every thread that records into it
+    TraceRecorder tracer(config.getTraceFile(), logger);
+    TraceRecorder::install(&tracer);
+    TraceRecorder::setThreadName("main");
     logger.info("KatieServer starting up...");
 
+    if (!config.getReplayFile().empty()) {
+        return runReplay(config, logger);
+    }
+
     // Initialize client manager
     ClientManager clientManager(logger, config);
 
     // Initialize network manager
     NetworkManager networkManager(clientManager, logger, config);
 
-    // Initialize game server
+    // Optional scrape endpoint, polled from the server loop between ticks
+    MetricsServer metrics(networkManager, logger);
+    metrics.setTraceRecorder(&tracer);
+    if (config.getMetricsPort() != 0) {
+        metrics.start(config.getMetricsPort());
+    }
+
+    if (config.getRoomCount() > 1) {
+        if (!config.getRecordFile().empty()) {
+            logger.warning("Replay recording covers a single room; --record is ignored with --rooms");
+        }
+        if (!config.getWorldFile().empty()) {
+            logger.warning("World files hold a single room; --world is ignored with --rooms");
+        }
+        return runRooms(config, logger, clientManager, networkManager, profiler, metrics, tracer);
+    }
+
+    // Initialize game server, warm-starting from the last checkpoint when there is one
     GameServer gameServer(logger, config);
-    gameServer.initialize();
+    bool restored = false;
+    if (!config.getWorldFile().empty()) {
+        auto loadStart = std::chrono::steady_clock::now();
+        MappedWorld world;
+        if (world.open(config.getWorldFile()) && gameServer.restoreWorld(world)) {
+            float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+            std::stringstream ss;
+            ss << "Restored world from " << config.getWorldFile() << ": " << world.planetCount() << " planets, "
+                << world.playerCount() << " saved players, tick " << world.header().sequenceNumber
+                << " (" << world.byteSize() << " bytes in " << milliseconds << "ms)";
+            logger.info(ss.str());
+            restored = true;
+        }
+        else {
+            logger.info("No usable world in " + config.getWorldFile() + ", starting a new one");
+        }
+    }
+    if (!restored) {
+        gameServer.initialize();
+    }
+
+    // Workers for the per-player, validation and gravity loops inside a tick.
+    // Multi-room hosting doesn't use this: its room workers already fill the cores
+    unsigned int jobThreads = config.getJobThreads() >= 0 ?
+        static_cast<unsigned int>(config.getJobThreads()) : JobSystem::defaultThreadCount();
+    JobSystem jobs(jobThreads);
+    gameServer.setJobSystem(&jobs);
+    metrics.setJobSystem(&jobs);
+    logger.info("Tick jobs run on " + std::to_string(jobThreads + 1) + " threads");
+
+    // Everything that changes the simulation goes to the replay log in the order it's applied
+    ReplayWriter recorder;
+    if (!config.getRecordFile().empty()) {
+        if (recorder.open(config.getRecordFile(), config.getUpdateRate())) {
+            logger.info("Recording replay to " + config.getRecordFile());
+            if (restored) {
+                logger.warning("Replays start from a new world; this one began from a checkpoint and won't replay");
+            }
+        }
+        else {
+            logger.error("Cannot open replay file " + config.getRecordFile() + ", not recording");
+        }
+    }
 
     // Set up callbacks
-    networkManager.setPlayerInputCallback([&gameServer](int clientId, const PlayerInput& input) {
+    networkManager.setPlayerInputCallback([&gameServer, &recorder](int clientId, const PlayerInput& input) {
+        if (recorder.isOpen()) {
+            recorder.recordInput(clientId, input);
+        }
         gameServer.handlePlayerInput(clientId, input);
         });
 
-    networkManager.setClientDisconnectedCallback([&gameServer](int clientId) {
+    networkManager.setClientDisconnectedCallback([&gameServer, &recorder](int clientId) {
+        if (recorder.isOpen()) {
+            recorder.recordDisconnect(clientId);
+        }
         gameServer.handlePlayerDisconnect(clientId);
         });
 
-    networkManager.setClientAuthenticatedCallback([&gameServer](int clientId, const std::string& username) {
+    networkManager.setClientAuthenticatedCallback([&gameServer, &recorder](int clientId, const std::string& username) {
         gameServer.addPlayer(clientId);
+
+        // The network layer has already spawned the player; record where
+        VehicleManager* player = gameServer.getPlayer(clientId);
+        if (recorder.isOpen() && player && player->getRocket()) {
+            recorder.recordConnect(clientId, player->getRocket()->getPosition());
+        }
         });
 
+    // Client simulations are queued here and validated in a batch on the next tick
+    networkManager.onClientSimulationReceived = [&gameServer](int clientId, const GameState& clientState) {
+        gameServer.processClientSimulation(clientId, clientState);
+        };
+
     // Start network manager
     if (!networkManager.start()) {
         logger.error("Failed to start network manager, exiting...");
@@ -112,42 +486,108 @@ int main(int argc, char* argv[]) {
 
     logger.info("Server started successfully!");
 
-    // Main loop timing variables
-    auto lastUpdateTime = std::chrono::steady_clock::now();
-    auto lastStatusTime = std::chrono::steady_clock::now();
+    // Fixed-step frame: receive, simulate, broadcast
+    TickScheduler scheduler(config.getUpdateRate(), config.getMaxCatchUpSteps());
+    SnapshotPipeline pipeline(networkManager);
+    GameState snapshot;
+    std::vector<int> corrections;
 
-    // Main server loop
-    while (running) {
-        // Calculate delta time
-        auto currentTime = std::chrono::steady_clock::now();
-        float deltaTime = std::chrono::duration<float>(currentTime - lastUpdateTime).count();
+    if (config.isPipelinedBroadcast()) {
+        pipeline.start();
+    }
+
+    // Accept connections and receive client messages
+    scheduler.setReceivePhase([&networkManager]() {
+        networkManager.update();
+        });
+
+    // World checkpoints: the tick copies the world into a flat snapshot and
+    // the checkpointer writes it out on its own thread
+    WorldCheckpointer checkpointer(config.getWorldFile(), logger);
+    WorldSnapshot worldSnapshot;
+    unsigned long checkpointTicks = 0;
+    if (!config.getWorldFile().empty()) {
+        checkpointer.start();
+        if (config.getCheckpointInterval() > 0.0f) {
+            checkpointTicks = std::max(1UL, static_cast<unsigned long>(config.getCheckpointInterval() / config.getUpdateRate() + 0.5f));
+        }
+    }
 
-        if (deltaTime >= config.getUpdateRate()) {
-            // Update game state
-            gameServer.update(deltaTime);
+    // Update game state by one fixed step
+    unsigned long ticksRecorded = 0;
+    unsigned long ticksSinceCheckpoint = 0;
+    scheduler.setSimulationPhase([&config, &gameServer, &recorder, &ticksRecorded,
+        &checkpointer, &worldSnapshot, checkpointTicks, &ticksSinceCheckpoint](float deltaTime) {
+        if (recorder.isOpen()) {
+            recorder.recordTick(deltaTime);
+        }
 
-            // Send game state to all clients
-            GameState state = gameServer.getGameState();
-            networkManager.sendGameState(state);
+        gameServer.update(deltaTime);
 
-            // Reset timer
-            lastUpdateTime = currentTime;
+        if (recorder.isOpen() && ++ticksRecorded % config.getKeyframeInterval() == 0) {
+            recorder.recordKeyframe(gameServer.getGameState());
         }
 
+        if (checkpointTicks > 0 && ++ticksSinceCheckpoint >= checkpointTicks) {
+            gameServer.captureWorld(worldSnapshot);
+            checkpointer.submit(worldSnapshot);
+            ticksSinceCheckpoint = 0;
+        }
+        });
+
+    // Send game state to all clients, flagging any pending corrections. When
+    // pipelined, the tick's state is frozen and handed to the snapshot worker
+    // so the next simulation step doesn't wait for the sockets
+    scheduler.setBroadcastPhase([&config, &gameServer, &networkManager, &pipeline, &snapshot, &corrections]() {
+        snapshot = gameServer.getGameState();
+        gameServer.takeCorrections(corrections);
+
+        if (config.isPipelinedBroadcast()) {
+            pipeline.publish(snapshot, corrections);
+        }
+        else {
+            networkManager.sendGameState(snapshot, corrections);
+        }
+        });
+
+    auto lastStatusTime = std::chrono::steady_clock::now();
+
+    // Main server loop
+    while (running) {
+        scheduler.runFrame();
+        metrics.poll();
+        pollTraceToggle(tracer);
+
         // Periodically log status (every 10 seconds)
+        auto currentTime = std::chrono::steady_clock::now();
         auto statusDuration = std::chrono::duration_cast<std::chrono::seconds>(currentTime - lastStatusTime).count();
         if (statusDuration >= 10) {
             clientManager.logClientInfo();
+            gameServer.logValidationStats(static_cast<float>(statusDuration));
+            scheduler.logStats(logger);
+            if (config.isProfiling()) {
+                profiler.logStats(logger);
+            }
+            if (config.isPipelinedBroadcast()) {
+                pipeline.logStats(logger);
+            }
             lastStatusTime = currentTime;
         }
-
-        // Sleep a bit to avoid hogging CPU
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
     // Graceful shutdown
     logger.info("Server shutting down...");
+    pipeline.stop();
     networkManager.stop();
 
+    // Save the final state so the next start picks up exactly here
+    if (!config.getWorldFile().empty()) {
+        gameServer.captureWorld(worldSnapshot);
+        checkpointer.submit(worldSnapshot);
+        checkpointer.stop();
+        logger.info("World saved to " + config.getWorldFile() + " (" +
+            std::to_string(checkpointer.getWrittenCount()) + " checkpoints written)");
+    }
+
     return 0;
 }
\ No newline at end of file